@@ -6,3 +6,4 @@
 library flutter_miniaudio;
 
 export 'src/miniaudio_player.dart';
+export 'src/miniaudio_bindings.dart' show MaBridgeRenderProcNative;
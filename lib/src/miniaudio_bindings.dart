@@ -18,7 +18,90 @@ typedef MaBridgeContextGetDeviceInfoNative = Int32 Function(
 typedef MaBridgeContextGetDeviceInfoDart = int Function(int type, int index,
     Pointer<Utf8> nameBuffer, int nameLen, Pointer<Void> idBuffer, int idLen);
 
+/// Mirrors `ma_bridge_device_format`. 0 means "any" for each field.
+final class MaBridgeDeviceFormat extends Struct {
+  @Int32()
+  external int format;
+
+  @Int32()
+  external int channels;
+
+  @Int32()
+  external int sampleRate;
+
+  @Int32()
+  external int flags;
+}
+
+/// Mirrors `ma_bridge_device_record`: one entry of the device snapshot.
+final class MaBridgeDeviceRecord extends Struct {
+  @Array(256) // MA_BRIDGE_DEVICE_NAME_LEN
+  external Array<Uint8> name;
+
+  @Array(256) // MA_BRIDGE_DEVICE_ID_LEN
+  external Array<Uint8> id;
+
+  @Int32()
+  external int isDefault;
+
+  @Int32()
+  external int formatCount;
+
+  @Array(16) // MA_BRIDGE_DEVICE_MAX_FORMATS
+  external Array<MaBridgeDeviceFormat> formats;
+}
+
+typedef MaBridgeContextGetDevicesNative = Int32 Function(
+    Int32 type, Pointer<MaBridgeDeviceRecord> records, Int32 capacity);
+typedef MaBridgeContextGetDevicesDart = int Function(
+    int type, Pointer<MaBridgeDeviceRecord> records, int capacity);
+
+typedef MaBridgeContextInvalidateDevicesNative = Void Function();
+typedef MaBridgeContextInvalidateDevicesDart = void Function();
+
+typedef MaBridgeSetBackendsNative = Int32 Function(
+    Pointer<Int32> backends, Int32 count);
+typedef MaBridgeSetBackendsDart = int Function(
+    Pointer<Int32> backends, int count);
+
+/// Mirrors `ma_bridge_backend_probe`: one backend attempt of the context init.
+final class MaBridgeBackendProbe extends Struct {
+  @Int32()
+  external int backend;
+
+  @Int32()
+  external int result;
+
+  @Uint64()
+  external int elapsedNs;
+}
+
+typedef MaBridgeContextGetBackendProbesNative = Int32 Function(
+    Pointer<MaBridgeBackendProbe> probes, Int32 capacity);
+typedef MaBridgeContextGetBackendProbesDart = int Function(
+    Pointer<MaBridgeBackendProbe> probes, int capacity);
+
+typedef MaBridgeContextGetBackendNative = Int32 Function();
+typedef MaBridgeContextGetBackendDart = int Function();
+
 // --- Device Types ---
+
+/// Mirrors `ma_bridge_fifo_positions`: monotonically increasing 64-bit
+/// sample counters, each padded to its own 64-byte cache line.
+final class MaBridgeFifoPositions extends Struct {
+  @Uint64()
+  external int writePos;
+
+  @Array(56)
+  external Array<Uint8> pad0;
+
+  @Uint64()
+  external int readPos;
+
+  @Array(56)
+  external Array<Uint8> pad1;
+}
+
 typedef MaBridgeInitNative = Int32 Function(Pointer<Void> deviceId,
     Int32 sampleRate, Int32 channels, Int32 bufferFrames);
 typedef MaBridgeInitDart = int Function(
@@ -27,14 +110,12 @@ typedef MaBridgeInitDart = int Function(
 typedef MaBridgeSetFifoNative = Void Function(
   Pointer<Int16> fifoPtr,
   Int32 capacitySamples,
-  Pointer<Int32> readPos,
-  Pointer<Int32> writePos,
+  Pointer<MaBridgeFifoPositions> positions,
 );
 typedef MaBridgeSetFifoDart = void Function(
   Pointer<Int16> fifoPtr,
   int capacitySamples,
-  Pointer<Int32> readPos,
-  Pointer<Int32> writePos,
+  Pointer<MaBridgeFifoPositions> positions,
 );
 
 typedef MaBridgeWritePcmFramesNative = Int32 Function(
@@ -42,6 +123,22 @@ typedef MaBridgeWritePcmFramesNative = Int32 Function(
 typedef MaBridgeWritePcmFramesDart = int Function(
     Pointer<Int16> data, int frameCount);
 
+typedef MaBridgeFifoReserveNative = Int32 Function(
+    Int32 frames,
+    Pointer<Pointer<Int16>> ptr1,
+    Pointer<Int32> len1,
+    Pointer<Pointer<Int16>> ptr2,
+    Pointer<Int32> len2);
+typedef MaBridgeFifoReserveDart = int Function(
+    int frames,
+    Pointer<Pointer<Int16>> ptr1,
+    Pointer<Int32> len1,
+    Pointer<Pointer<Int16>> ptr2,
+    Pointer<Int32> len2);
+
+typedef MaBridgeFifoCommitNative = Int32 Function(Int32 frames);
+typedef MaBridgeFifoCommitDart = int Function(int frames);
+
 typedef MaBridgeStartNative = Int32 Function();
 typedef MaBridgeStartDart = int Function();
 
@@ -57,6 +154,18 @@ typedef MaBridgeGetFifoAvailableDart = int Function();
 typedef MaBridgeSetLogEnabledNative = Void Function(Int32 enabled);
 typedef MaBridgeSetLogEnabledDart = void Function(int enabled);
 
+// --- Logging Types ---
+typedef MaBridgeLogSetIntNative = Void Function(Int32 value);
+typedef MaBridgeLogSetIntDart = void Function(int value);
+typedef MaBridgeLogSetPortNative = Void Function(
+    Pointer<Void> postCObject, Int64 port);
+typedef MaBridgeLogSetPortDart = void Function(
+    Pointer<Void> postCObject, int port);
+typedef MaBridgeLogGetDroppedNative = Uint64 Function();
+typedef MaBridgeLogGetDroppedDart = int Function();
+typedef MaBridgeLogFlushNative = Void Function();
+typedef MaBridgeLogFlushDart = void Function();
+
 typedef MaBridgeSetVolumeNative = Void Function(Float volume);
 typedef MaBridgeSetVolumeDart = void Function(double volume);
 
@@ -66,6 +175,50 @@ typedef MaBridgeGetDeviceSampleRateDart = int Function();
 typedef MaBridgeGetDeviceChannelsNative = Int32 Function();
 typedef MaBridgeGetDeviceChannelsDart = int Function();
 
+/// Mirrors `ma_bridge_device_config`: options for devices opened afterwards.
+final class MaBridgeDeviceConfig extends Struct {
+  @Int32()
+  external int periods;
+
+  @Int32()
+  external int conservative;
+
+  @Int32()
+  external int noPreSilencedOutputBuffer;
+
+  @Int32()
+  external int noClip;
+
+  @Int32()
+  external int noFixedSizedCallback;
+
+  @Int32()
+  external int noDisableDenormals;
+
+  @Int32()
+  external int exclusive;
+
+  @Int32()
+  external int alsaNoMMap;
+
+  @Int32()
+  external int alsaNoAutoFormat;
+
+  @Int32()
+  external int alsaNoAutoChannels;
+
+  @Int32()
+  external int alsaNoAutoResample;
+
+  @Int32()
+  external int aaudioAllowSetBufferCapacity;
+}
+
+typedef MaBridgeSetDeviceConfigNative = Void Function(
+    Pointer<MaBridgeDeviceConfig> config);
+typedef MaBridgeSetDeviceConfigDart = void Function(
+    Pointer<MaBridgeDeviceConfig> config);
+
 // --- Resampler Types ---
 typedef MaBridgeInitResamplerNative = Int32 Function(
     Int32 sourceSampleRate, Int32 targetSampleRate);
@@ -75,6 +228,343 @@ typedef MaBridgeInitResamplerDart = int Function(
 typedef MaBridgeSetResamplingRatioNative = Void Function(Float ratio);
 typedef MaBridgeSetResamplingRatioDart = void Function(double ratio);
 
+// --- Stream Types (Multi-Instance) ---
+
+/// Opaque `ma_bridge_stream` handle: one device with its own FIFO and resampler.
+final class MaBridgeStream extends Opaque {}
+
+typedef MaBridgeStreamCreateNative = Pointer<MaBridgeStream> Function(
+    Pointer<Void> deviceId,
+    Int32 sampleRate,
+    Int32 channels,
+    Int32 bufferFrames,
+    Int32 format);
+typedef MaBridgeStreamCreateDart = Pointer<MaBridgeStream> Function(
+    Pointer<Void> deviceId,
+    int sampleRate,
+    int channels,
+    int bufferFrames,
+    int format);
+
+/// Native producer callback (ma_bridge_render_proc): renders up to
+/// `frameCount` frames into `output` and returns the number rendered.
+typedef MaBridgeRenderProcNative = Int32 Function(
+    Pointer<Void> userData, Pointer<Void> output, Int32 frameCount);
+
+typedef MaBridgeStreamCreateWithRenderCallbackNative = Pointer<MaBridgeStream>
+    Function(
+        Pointer<Void> deviceId,
+        Int32 sampleRate,
+        Int32 channels,
+        Int32 bufferFrames,
+        Int32 format,
+        Pointer<NativeFunction<MaBridgeRenderProcNative>> render,
+        Pointer<Void> userData);
+typedef MaBridgeStreamCreateWithRenderCallbackDart = Pointer<MaBridgeStream>
+    Function(
+        Pointer<Void> deviceId,
+        int sampleRate,
+        int channels,
+        int bufferFrames,
+        int format,
+        Pointer<NativeFunction<MaBridgeRenderProcNative>> render,
+        Pointer<Void> userData);
+
+/// Native duplex callback (ma_bridge_duplex_proc): turns `frameCount` input
+/// frames into output and returns the number of output frames written.
+typedef MaBridgeDuplexProcNative = Int32 Function(Pointer<Void> userData,
+    Pointer<Void> input, Pointer<Void> output, Int32 frameCount);
+
+typedef MaBridgeStreamCreateDuplexNative = Pointer<MaBridgeStream> Function(
+    Pointer<Void> playbackDeviceId,
+    Pointer<Void> captureDeviceId,
+    Int32 sampleRate,
+    Int32 channels,
+    Int32 bufferFrames,
+    Int32 format,
+    Pointer<NativeFunction<MaBridgeDuplexProcNative>> process,
+    Pointer<Void> userData);
+typedef MaBridgeStreamCreateDuplexDart = Pointer<MaBridgeStream> Function(
+    Pointer<Void> playbackDeviceId,
+    Pointer<Void> captureDeviceId,
+    int sampleRate,
+    int channels,
+    int bufferFrames,
+    int format,
+    Pointer<NativeFunction<MaBridgeDuplexProcNative>> process,
+    Pointer<Void> userData);
+
+typedef MaBridgeStreamCreateOfflineNative = Pointer<MaBridgeStream> Function(
+    Int32 sampleRate,
+    Int32 channels,
+    Int32 bufferFrames,
+    Int32 format,
+    Int32 deviceFormat);
+typedef MaBridgeStreamCreateOfflineDart = Pointer<MaBridgeStream> Function(
+    int sampleRate,
+    int channels,
+    int bufferFrames,
+    int format,
+    int deviceFormat);
+
+typedef MaBridgeStreamSetOfflineClockNative = Int32 Function(
+    Pointer<MaBridgeStream> stream, Float speed, Int32 jitterUs, Uint32 seed);
+typedef MaBridgeStreamSetOfflineClockDart = int Function(
+    Pointer<MaBridgeStream> stream, double speed, int jitterUs, int seed);
+
+typedef MaBridgeStreamPumpNative = Int32 Function(
+    Pointer<MaBridgeStream> stream, Int32 periods, Pointer<Void> output);
+typedef MaBridgeStreamPumpDart = int Function(
+    Pointer<MaBridgeStream> stream, int periods, Pointer<Void> output);
+
+typedef MaBridgeStreamDestroyNative = Void Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamDestroyDart = void Function(
+    Pointer<MaBridgeStream> stream);
+
+typedef MaBridgeStreamSetFifoNative = Void Function(
+  Pointer<MaBridgeStream> stream,
+  Pointer<Void> fifoPtr,
+  Int32 capacitySamples,
+  Pointer<MaBridgeFifoPositions> positions,
+);
+typedef MaBridgeStreamSetFifoDart = void Function(
+  Pointer<MaBridgeStream> stream,
+  Pointer<Void> fifoPtr,
+  int capacitySamples,
+  Pointer<MaBridgeFifoPositions> positions,
+);
+
+typedef MaBridgeStreamStartNative = Int32 Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamStartDart = int Function(Pointer<MaBridgeStream> stream);
+
+typedef MaBridgeStreamStopNative = Int32 Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamStopDart = int Function(Pointer<MaBridgeStream> stream);
+
+typedef MaBridgeStreamGetFramesConsumedNative = Uint64 Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamGetFramesConsumedDart = int Function(
+    Pointer<MaBridgeStream> stream);
+
+typedef MaBridgeStreamGetInt32Native = Int32 Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamGetInt32Dart = int Function(
+    Pointer<MaBridgeStream> stream);
+
+typedef MaBridgeStreamSetVolumeNative = Void Function(
+    Pointer<MaBridgeStream> stream, Float volume);
+typedef MaBridgeStreamSetVolumeDart = void Function(
+    Pointer<MaBridgeStream> stream, double volume);
+
+typedef MaBridgeStreamWritePcmFramesNative = Int32 Function(
+    Pointer<MaBridgeStream> stream, Pointer<Void> data, Int32 frameCount);
+typedef MaBridgeStreamWritePcmFramesDart = int Function(
+    Pointer<MaBridgeStream> stream, Pointer<Void> data, int frameCount);
+
+typedef MaBridgeStreamFifoReserveNative = Int32 Function(
+    Pointer<MaBridgeStream> stream,
+    Int32 frames,
+    Pointer<Pointer<Void>> ptr1,
+    Pointer<Int32> len1,
+    Pointer<Pointer<Void>> ptr2,
+    Pointer<Int32> len2);
+typedef MaBridgeStreamFifoReserveDart = int Function(
+    Pointer<MaBridgeStream> stream,
+    int frames,
+    Pointer<Pointer<Void>> ptr1,
+    Pointer<Int32> len1,
+    Pointer<Pointer<Void>> ptr2,
+    Pointer<Int32> len2);
+
+typedef MaBridgeStreamFifoCommitNative = Int32 Function(
+    Pointer<MaBridgeStream> stream, Int32 frames);
+typedef MaBridgeStreamFifoCommitDart = int Function(
+    Pointer<MaBridgeStream> stream, int frames);
+
+typedef MaBridgeStreamInitResamplerNative = Int32 Function(
+    Pointer<MaBridgeStream> stream,
+    Int32 sourceSampleRate,
+    Int32 targetSampleRate);
+typedef MaBridgeStreamInitResamplerDart = int Function(
+    Pointer<MaBridgeStream> stream, int sourceSampleRate, int targetSampleRate);
+
+typedef MaBridgeStreamSetResamplingRatioNative = Void Function(
+    Pointer<MaBridgeStream> stream, Float ratio);
+typedef MaBridgeStreamSetResamplingRatioDart = void Function(
+    Pointer<MaBridgeStream> stream, double ratio);
+
+typedef MaBridgeStreamSetResampleQualityNative = Void Function(
+    Pointer<MaBridgeStream> stream, Int32 quality);
+typedef MaBridgeStreamSetResampleQualityDart = void Function(
+    Pointer<MaBridgeStream> stream, int quality);
+
+typedef MaBridgeStreamInitPullResamplerNative = Int32 Function(
+    Pointer<MaBridgeStream> stream, Int32 sourceSampleRate);
+typedef MaBridgeStreamInitPullResamplerDart = int Function(
+    Pointer<MaBridgeStream> stream, int sourceSampleRate);
+
+typedef MaBridgeStreamSetRateControlNative = Void Function(
+    Pointer<MaBridgeStream> stream, Int32 targetLatencyFrames, Float maxSkew);
+typedef MaBridgeStreamSetRateControlDart = void Function(
+    Pointer<MaBridgeStream> stream, int targetLatencyFrames, double maxSkew);
+
+typedef MaBridgeStreamGetResamplingRatioNative = Float Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamGetResamplingRatioDart = double Function(
+    Pointer<MaBridgeStream> stream);
+
+// --- Stream Telemetry Types ---
+
+/// Mirrors `ma_bridge_stream_stats` (version 1). The first 64 bytes are
+/// written by the audio thread under the [sequence] seqlock; the overrun
+/// counters are written by the producer.
+final class MaBridgeStreamStats extends Struct {
+  @Uint32()
+  external int version;
+
+  @Uint32()
+  external int size;
+
+  @Uint32()
+  external int sequence;
+
+  @Uint32()
+  external int resetRequested;
+
+  @Uint64()
+  external int framesConsumed;
+
+  @Uint64()
+  external int callbackCount;
+
+  @Uint64()
+  external int underrunEvents;
+
+  @Uint64()
+  external int underrunFrames;
+
+  @Uint64()
+  external int fillMinFrames;
+
+  @Uint64()
+  external int fillMaxFrames;
+
+  @Uint64()
+  external int overrunEvents;
+
+  @Uint64()
+  external int overrunFrames;
+
+  @Array(48)
+  external Array<Uint8> pad;
+}
+
+typedef MaBridgeStreamGetStatsNative = Pointer<MaBridgeStreamStats> Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamGetStatsDart = Pointer<MaBridgeStreamStats> Function(
+    Pointer<MaBridgeStream> stream);
+
+typedef MaBridgeStreamResetStatsNative = Void Function(
+    Pointer<MaBridgeStream> stream);
+typedef MaBridgeStreamResetStatsDart = void Function(
+    Pointer<MaBridgeStream> stream);
+
+typedef MaBridgeStreamStatsSequenceNative = Uint32 Function(
+    Pointer<MaBridgeStreamStats> stats);
+typedef MaBridgeStreamStatsSequenceDart = int Function(
+    Pointer<MaBridgeStreamStats> stats);
+
+// --- Callback Trace Types ---
+
+/// Mirrors `ma_bridge_callback_trace`.
+final class MaBridgeCallbackTrace extends Struct {
+  @Uint64()
+  external int startNs;
+
+  @Uint64()
+  external int endNs;
+
+  @Uint32()
+  external int framesRequested;
+
+  @Uint32()
+  external int framesDelivered;
+}
+
+/// Mirrors `ma_bridge_trace_summary` (MA_BRIDGE_JITTER_BINS = 16).
+final class MaBridgeTraceSummary extends Struct {
+  @Uint64()
+  external int callbacks;
+
+  @Uint64()
+  external int dropped;
+
+  @Double()
+  external double loadMean;
+
+  @Double()
+  external double loadMax;
+
+  @Int64()
+  external int intervalErrorMinNs;
+
+  @Int64()
+  external int intervalErrorMaxNs;
+
+  @Array(16)
+  external Array<Uint64> jitterHistogram;
+}
+
+typedef MaBridgeNowNsNative = Uint64 Function();
+typedef MaBridgeNowNsDart = int Function();
+
+typedef MaBridgeStreamSetTraceEnabledNative = Void Function(
+    Pointer<MaBridgeStream> stream, Int32 enabled);
+typedef MaBridgeStreamSetTraceEnabledDart = void Function(
+    Pointer<MaBridgeStream> stream, int enabled);
+
+typedef MaBridgeStreamDrainTraceNative = Int32 Function(
+    Pointer<MaBridgeStream> stream,
+    Pointer<MaBridgeCallbackTrace> out,
+    Int32 max);
+typedef MaBridgeStreamDrainTraceDart = int Function(
+    Pointer<MaBridgeStream> stream, Pointer<MaBridgeCallbackTrace> out, int max);
+
+typedef MaBridgeStreamGetTraceSummaryNative = Void Function(
+    Pointer<MaBridgeStream> stream, Pointer<MaBridgeTraceSummary> out);
+typedef MaBridgeStreamGetTraceSummaryDart = void Function(
+    Pointer<MaBridgeStream> stream, Pointer<MaBridgeTraceSummary> out);
+
+// --- Playback Timestamp Types ---
+typedef MaBridgeStreamGetTimestampNative = Int32 Function(
+    Pointer<MaBridgeStream> stream,
+    Pointer<Uint64> framePosition,
+    Pointer<Uint64> hostTimeNs);
+typedef MaBridgeStreamGetTimestampDart = int Function(
+    Pointer<MaBridgeStream> stream,
+    Pointer<Uint64> framePosition,
+    Pointer<Uint64> hostTimeNs);
+
+// --- Blocking Wait Types ---
+typedef MaBridgeStreamWaitNative = Int32 Function(
+    Pointer<MaBridgeStream> stream, Int32 frames, Uint64 timeoutNs);
+typedef MaBridgeStreamWaitDart = int Function(
+    Pointer<MaBridgeStream> stream, int frames, int timeoutNs);
+
+// --- Low-Water Notification Types ---
+typedef MaBridgeStreamSetLowWaterNotifyNative = Int32 Function(
+    Pointer<MaBridgeStream> stream,
+    Pointer<Void> postCObject,
+    Int64 port,
+    Int32 watermarkFrames);
+typedef MaBridgeStreamSetLowWaterNotifyDart = int Function(
+    Pointer<MaBridgeStream> stream,
+    Pointer<Void> postCObject,
+    int port,
+    int watermarkFrames);
+
 // --- Engine Types ---
 typedef MaBridgeEngineInitNative = Int32 Function();
 typedef MaBridgeEngineInitDart = int Function();
@@ -410,6 +900,11 @@ class MiniaudioBindings {
   // Context
   late final MaBridgeContextGetDeviceCountDart contextGetDeviceCount;
   late final MaBridgeContextGetDeviceInfoDart contextGetDeviceInfo;
+  late final MaBridgeContextGetDevicesDart contextGetDevices;
+  late final MaBridgeContextInvalidateDevicesDart contextInvalidateDevices;
+  late final MaBridgeSetBackendsDart setBackends;
+  late final MaBridgeContextGetBackendProbesDart contextGetBackendProbes;
+  late final MaBridgeContextGetBackendDart contextGetBackend;
 
   // Device
   late final MaBridgeInitDart init;
@@ -424,11 +919,88 @@ class MiniaudioBindings {
   late final MaBridgeGetDeviceChannelsDart getDeviceChannels;
   late final MaBridgeDeinitDart deinit;
   late final MaBridgeWritePcmFramesDart writePcmFrames;
+  late final MaBridgeWritePcmFramesDart writeDeviceFifo;
+  late final MaBridgeFifoReserveDart fifoReserve;
+  late final MaBridgeFifoCommitDart fifoCommit;
+  late final MaBridgeSetDeviceConfigDart setDeviceConfig;
+
+  // Logging
+  late final MaBridgeLogSetIntDart logSetLevel;
+  late final MaBridgeLogSetIntDart logSetStdout;
+  late final MaBridgeLogSetPortDart logSetPort;
+  late final MaBridgeLogGetDroppedDart logGetDropped;
+  late final MaBridgeLogFlushDart logFlush;
 
   // Resampler
   late final MaBridgeInitResamplerDart initResampler;
   late final MaBridgeSetResamplingRatioDart setResamplingRatio;
 
+  // Stream (Multi-Instance)
+  late final MaBridgeStreamCreateDart streamCreate;
+  late final MaBridgeStreamCreateWithRenderCallbackDart
+      streamCreateWithRenderCallback;
+  late final MaBridgeStreamDestroyDart streamDestroy;
+  late final MaBridgeStreamSetFifoDart streamSetFifo;
+  late final MaBridgeStreamStartDart streamStart;
+  late final MaBridgeStreamStopDart streamStop;
+  late final MaBridgeStreamGetFramesConsumedDart streamGetFramesConsumed;
+  late final MaBridgeStreamGetInt32Dart streamGetFifoAvailable;
+  late final MaBridgeStreamSetVolumeDart streamSetVolume;
+  late final MaBridgeStreamGetInt32Dart streamGetDeviceSampleRate;
+  late final MaBridgeStreamGetInt32Dart streamGetDeviceChannels;
+  late final MaBridgeStreamWritePcmFramesDart streamWritePcmFrames;
+  late final MaBridgeStreamWritePcmFramesDart streamWriteDeviceFifo;
+  late final MaBridgeStreamFifoReserveDart streamFifoReserve;
+  late final MaBridgeStreamFifoCommitDart streamFifoCommit;
+  late final MaBridgeStreamInitResamplerDart streamInitResampler;
+  late final MaBridgeStreamSetResampleQualityDart streamSetResampleQuality;
+  late final MaBridgeStreamSetResamplingRatioDart streamSetResamplingRatio;
+  late final MaBridgeStreamSetResamplingRatioDart streamSetPlaybackSpeed;
+  late final MaBridgeStreamSetRateControlDart streamSetRateControl;
+  late final MaBridgeStreamGetResamplingRatioDart streamGetResamplingRatio;
+  late final MaBridgeStreamInitPullResamplerDart streamInitPullResampler;
+  late final MaBridgeStreamGetStatsDart streamGetStats;
+  late final MaBridgeStreamResetStatsDart streamResetStats;
+  late final MaBridgeStreamStatsSequenceDart streamStatsSequence;
+
+  // Callback Trace
+  late final MaBridgeNowNsDart nowNs;
+  late final MaBridgeStreamSetTraceEnabledDart streamSetTraceEnabled;
+  late final MaBridgeStreamDrainTraceDart streamDrainTrace;
+  late final MaBridgeStreamGetTraceSummaryDart streamGetTraceSummary;
+  late final MaBridgeStreamResetStatsDart streamResetTraceSummary;
+
+  // Playback Timestamp
+  late final MaBridgeStreamGetTimestampDart streamGetTimestamp;
+  late final MaBridgeStreamGetInt32Dart streamGetOutputLatencyFrames;
+
+  // Blocking Waits
+  late final MaBridgeStreamWaitDart streamWaitForSpace;
+  late final MaBridgeStreamWaitDart streamWaitBelowFill;
+
+  // Low-Water Notification
+  late final MaBridgeStreamSetLowWaterNotifyDart streamSetLowWaterNotify;
+
+  // Capture Streams (signatures shared with their playback counterparts)
+  late final MaBridgeStreamCreateDart streamCreateCapture;
+  late final MaBridgeStreamSetFifoDart streamSetCaptureFifo;
+  late final MaBridgeStreamGetInt32Dart streamGetCaptureFifoAvailable;
+  late final MaBridgeStreamFifoReserveDart streamCaptureAcquire;
+  late final MaBridgeStreamFifoCommitDart streamCaptureRelease;
+  late final MaBridgeStreamWritePcmFramesDart streamReadCapture;
+  late final MaBridgeStreamWaitDart streamWaitForCapture;
+  late final MaBridgeStreamGetStatsDart streamGetCaptureStats;
+  late final MaBridgeStreamGetTimestampDart streamGetCaptureTimestamp;
+  late final MaBridgeStreamGetInt32Dart streamGetInputLatencyFrames;
+
+  // Duplex Streams
+  late final MaBridgeStreamCreateDuplexDart streamCreateDuplex;
+
+  // Offline Streams
+  late final MaBridgeStreamCreateOfflineDart streamCreateOffline;
+  late final MaBridgeStreamSetOfflineClockDart streamSetOfflineClock;
+  late final MaBridgeStreamPumpDart streamPump;
+
   // Engine
   late final MaBridgeEngineInitDart engineInit;
   late final MaBridgeEngineUninitDart engineUninit;
@@ -528,6 +1100,21 @@ class MiniaudioBindings {
     contextGetDeviceInfo = _lib.lookupFunction<
         MaBridgeContextGetDeviceInfoNative,
         MaBridgeContextGetDeviceInfoDart>('ma_bridge_context_get_device_info');
+    contextGetDevices = _lib.lookupFunction<MaBridgeContextGetDevicesNative,
+        MaBridgeContextGetDevicesDart>('ma_bridge_context_get_devices');
+    contextInvalidateDevices = _lib.lookupFunction<
+            MaBridgeContextInvalidateDevicesNative,
+            MaBridgeContextInvalidateDevicesDart>(
+        'ma_bridge_context_invalidate_devices');
+    setBackends =
+        _lib.lookupFunction<MaBridgeSetBackendsNative, MaBridgeSetBackendsDart>(
+            'ma_bridge_set_backends');
+    contextGetBackendProbes = _lib.lookupFunction<
+            MaBridgeContextGetBackendProbesNative,
+            MaBridgeContextGetBackendProbesDart>(
+        'ma_bridge_context_get_backend_probes');
+    contextGetBackend = _lib.lookupFunction<MaBridgeContextGetBackendNative,
+        MaBridgeContextGetBackendDart>('ma_bridge_context_get_backend');
 
     // Device
     init = _lib.lookupFunction<MaBridgeInitNative, MaBridgeInitDart>(
@@ -555,6 +1142,32 @@ class MiniaudioBindings {
         'ma_bridge_deinit');
     writePcmFrames = _lib.lookupFunction<MaBridgeWritePcmFramesNative,
         MaBridgeWritePcmFramesDart>('ma_bridge_write_pcm_frames');
+    writeDeviceFifo = _lib.lookupFunction<MaBridgeWritePcmFramesNative,
+        MaBridgeWritePcmFramesDart>('ma_bridge_write_device_fifo');
+    fifoReserve =
+        _lib.lookupFunction<MaBridgeFifoReserveNative, MaBridgeFifoReserveDart>(
+            'ma_bridge_fifo_reserve');
+    fifoCommit =
+        _lib.lookupFunction<MaBridgeFifoCommitNative, MaBridgeFifoCommitDart>(
+            'ma_bridge_fifo_commit');
+    setDeviceConfig = _lib.lookupFunction<MaBridgeSetDeviceConfigNative,
+        MaBridgeSetDeviceConfigDart>('ma_bridge_set_device_config');
+
+    // Logging
+    logSetLevel =
+        _lib.lookupFunction<MaBridgeLogSetIntNative, MaBridgeLogSetIntDart>(
+            'ma_bridge_log_set_level');
+    logSetStdout =
+        _lib.lookupFunction<MaBridgeLogSetIntNative, MaBridgeLogSetIntDart>(
+            'ma_bridge_log_set_stdout');
+    logSetPort =
+        _lib.lookupFunction<MaBridgeLogSetPortNative, MaBridgeLogSetPortDart>(
+            'ma_bridge_log_set_port');
+    logGetDropped = _lib.lookupFunction<MaBridgeLogGetDroppedNative,
+        MaBridgeLogGetDroppedDart>('ma_bridge_log_get_dropped');
+    logFlush =
+        _lib.lookupFunction<MaBridgeLogFlushNative, MaBridgeLogFlushDart>(
+            'ma_bridge_log_flush');
 
     // Resampler
     initResampler = _lib.lookupFunction<MaBridgeInitResamplerNative,
@@ -562,6 +1175,161 @@ class MiniaudioBindings {
     setResamplingRatio = _lib.lookupFunction<MaBridgeSetResamplingRatioNative,
         MaBridgeSetResamplingRatioDart>('ma_bridge_set_resampling_ratio');
 
+    // Stream (Multi-Instance)
+    streamCreate =
+        _lib.lookupFunction<MaBridgeStreamCreateNative, MaBridgeStreamCreateDart>(
+            'ma_bridge_stream_create');
+    streamCreateWithRenderCallback = _lib.lookupFunction<
+            MaBridgeStreamCreateWithRenderCallbackNative,
+            MaBridgeStreamCreateWithRenderCallbackDart>(
+        'ma_bridge_stream_create_with_render_callback');
+    streamDestroy = _lib.lookupFunction<MaBridgeStreamDestroyNative,
+        MaBridgeStreamDestroyDart>('ma_bridge_stream_destroy');
+    streamSetFifo = _lib.lookupFunction<MaBridgeStreamSetFifoNative,
+        MaBridgeStreamSetFifoDart>('ma_bridge_stream_set_fifo');
+    streamStart =
+        _lib.lookupFunction<MaBridgeStreamStartNative, MaBridgeStreamStartDart>(
+            'ma_bridge_stream_start');
+    streamStop =
+        _lib.lookupFunction<MaBridgeStreamStopNative, MaBridgeStreamStopDart>(
+            'ma_bridge_stream_stop');
+    streamGetFramesConsumed = _lib.lookupFunction<
+            MaBridgeStreamGetFramesConsumedNative,
+            MaBridgeStreamGetFramesConsumedDart>(
+        'ma_bridge_stream_get_frames_consumed');
+    streamGetFifoAvailable = _lib.lookupFunction<MaBridgeStreamGetInt32Native,
+        MaBridgeStreamGetInt32Dart>('ma_bridge_stream_get_fifo_available');
+    streamSetVolume = _lib.lookupFunction<MaBridgeStreamSetVolumeNative,
+        MaBridgeStreamSetVolumeDart>('ma_bridge_stream_set_volume');
+    streamGetDeviceSampleRate = _lib.lookupFunction<
+        MaBridgeStreamGetInt32Native,
+        MaBridgeStreamGetInt32Dart>('ma_bridge_stream_get_device_sample_rate');
+    streamGetDeviceChannels = _lib.lookupFunction<MaBridgeStreamGetInt32Native,
+        MaBridgeStreamGetInt32Dart>('ma_bridge_stream_get_device_channels');
+    streamWritePcmFrames = _lib.lookupFunction<
+        MaBridgeStreamWritePcmFramesNative,
+        MaBridgeStreamWritePcmFramesDart>('ma_bridge_stream_write_pcm_frames');
+    streamWriteDeviceFifo = _lib.lookupFunction<
+        MaBridgeStreamWritePcmFramesNative,
+        MaBridgeStreamWritePcmFramesDart>('ma_bridge_stream_write_device_fifo');
+    streamFifoReserve = _lib.lookupFunction<MaBridgeStreamFifoReserveNative,
+        MaBridgeStreamFifoReserveDart>('ma_bridge_stream_fifo_reserve');
+    streamFifoCommit = _lib.lookupFunction<MaBridgeStreamFifoCommitNative,
+        MaBridgeStreamFifoCommitDart>('ma_bridge_stream_fifo_commit');
+    streamInitResampler = _lib.lookupFunction<
+        MaBridgeStreamInitResamplerNative,
+        MaBridgeStreamInitResamplerDart>('ma_bridge_stream_init_resampler');
+    streamSetResamplingRatio = _lib.lookupFunction<
+            MaBridgeStreamSetResamplingRatioNative,
+            MaBridgeStreamSetResamplingRatioDart>(
+        'ma_bridge_stream_set_resampling_ratio');
+    streamSetPlaybackSpeed = _lib.lookupFunction<
+            MaBridgeStreamSetResamplingRatioNative,
+            MaBridgeStreamSetResamplingRatioDart>(
+        'ma_bridge_stream_set_playback_speed');
+    streamSetRateControl = _lib.lookupFunction<
+            MaBridgeStreamSetRateControlNative,
+            MaBridgeStreamSetRateControlDart>(
+        'ma_bridge_stream_set_rate_control');
+    streamGetResamplingRatio = _lib.lookupFunction<
+            MaBridgeStreamGetResamplingRatioNative,
+            MaBridgeStreamGetResamplingRatioDart>(
+        'ma_bridge_stream_get_resampling_ratio');
+    streamSetResampleQuality = _lib.lookupFunction<
+            MaBridgeStreamSetResampleQualityNative,
+            MaBridgeStreamSetResampleQualityDart>(
+        'ma_bridge_stream_set_resample_quality');
+    streamInitPullResampler = _lib.lookupFunction<
+            MaBridgeStreamInitPullResamplerNative,
+            MaBridgeStreamInitPullResamplerDart>(
+        'ma_bridge_stream_init_pull_resampler');
+    streamGetStats = _lib.lookupFunction<MaBridgeStreamGetStatsNative,
+        MaBridgeStreamGetStatsDart>('ma_bridge_stream_get_stats');
+    streamResetStats = _lib.lookupFunction<MaBridgeStreamResetStatsNative,
+        MaBridgeStreamResetStatsDart>('ma_bridge_stream_reset_stats');
+    streamStatsSequence = _lib.lookupFunction<MaBridgeStreamStatsSequenceNative,
+            MaBridgeStreamStatsSequenceDart>('ma_bridge_stream_stats_sequence',
+        isLeaf: true);
+
+    // Callback Trace
+    nowNs = _lib.lookupFunction<MaBridgeNowNsNative, MaBridgeNowNsDart>(
+        'ma_bridge_now_ns');
+    streamSetTraceEnabled = _lib.lookupFunction<
+        MaBridgeStreamSetTraceEnabledNative,
+        MaBridgeStreamSetTraceEnabledDart>('ma_bridge_stream_set_trace_enabled');
+    streamDrainTrace = _lib.lookupFunction<MaBridgeStreamDrainTraceNative,
+        MaBridgeStreamDrainTraceDart>('ma_bridge_stream_drain_trace');
+    streamGetTraceSummary = _lib.lookupFunction<
+        MaBridgeStreamGetTraceSummaryNative,
+        MaBridgeStreamGetTraceSummaryDart>('ma_bridge_stream_get_trace_summary');
+    streamResetTraceSummary = _lib.lookupFunction<
+        MaBridgeStreamResetStatsNative,
+        MaBridgeStreamResetStatsDart>('ma_bridge_stream_reset_trace_summary');
+
+    // Playback Timestamp
+    streamGetTimestamp = _lib.lookupFunction<MaBridgeStreamGetTimestampNative,
+        MaBridgeStreamGetTimestampDart>('ma_bridge_stream_get_timestamp');
+    streamGetOutputLatencyFrames = _lib.lookupFunction<
+            MaBridgeStreamGetInt32Native, MaBridgeStreamGetInt32Dart>(
+        'ma_bridge_stream_get_output_latency_frames');
+
+    // Blocking Waits
+    streamWaitForSpace =
+        _lib.lookupFunction<MaBridgeStreamWaitNative, MaBridgeStreamWaitDart>(
+            'ma_bridge_stream_wait_for_space');
+    streamWaitBelowFill =
+        _lib.lookupFunction<MaBridgeStreamWaitNative, MaBridgeStreamWaitDart>(
+            'ma_bridge_stream_wait_below_fill');
+
+    // Low-Water Notification
+    streamSetLowWaterNotify = _lib.lookupFunction<
+            MaBridgeStreamSetLowWaterNotifyNative,
+            MaBridgeStreamSetLowWaterNotifyDart>(
+        'ma_bridge_stream_set_low_water_notify');
+
+    // Capture Streams
+    streamCreateCapture =
+        _lib.lookupFunction<MaBridgeStreamCreateNative, MaBridgeStreamCreateDart>(
+            'ma_bridge_stream_create_capture');
+    streamSetCaptureFifo = _lib.lookupFunction<MaBridgeStreamSetFifoNative,
+        MaBridgeStreamSetFifoDart>('ma_bridge_stream_set_capture_fifo');
+    streamGetCaptureFifoAvailable = _lib.lookupFunction<
+            MaBridgeStreamGetInt32Native, MaBridgeStreamGetInt32Dart>(
+        'ma_bridge_stream_get_capture_fifo_available');
+    streamCaptureAcquire = _lib.lookupFunction<MaBridgeStreamFifoReserveNative,
+        MaBridgeStreamFifoReserveDart>('ma_bridge_stream_capture_acquire');
+    streamCaptureRelease = _lib.lookupFunction<MaBridgeStreamFifoCommitNative,
+        MaBridgeStreamFifoCommitDart>('ma_bridge_stream_capture_release');
+    streamReadCapture = _lib.lookupFunction<
+        MaBridgeStreamWritePcmFramesNative,
+        MaBridgeStreamWritePcmFramesDart>('ma_bridge_stream_read_capture');
+    streamWaitForCapture =
+        _lib.lookupFunction<MaBridgeStreamWaitNative, MaBridgeStreamWaitDart>(
+            'ma_bridge_stream_wait_for_capture');
+    streamGetCaptureStats = _lib.lookupFunction<MaBridgeStreamGetStatsNative,
+        MaBridgeStreamGetStatsDart>('ma_bridge_stream_get_capture_stats');
+    streamGetCaptureTimestamp = _lib.lookupFunction<
+            MaBridgeStreamGetTimestampNative, MaBridgeStreamGetTimestampDart>(
+        'ma_bridge_stream_get_capture_timestamp');
+    streamGetInputLatencyFrames = _lib.lookupFunction<
+            MaBridgeStreamGetInt32Native, MaBridgeStreamGetInt32Dart>(
+        'ma_bridge_stream_get_input_latency_frames');
+
+    // Duplex Streams
+    streamCreateDuplex = _lib.lookupFunction<MaBridgeStreamCreateDuplexNative,
+        MaBridgeStreamCreateDuplexDart>('ma_bridge_stream_create_duplex');
+
+    // Offline Streams
+    streamCreateOffline = _lib.lookupFunction<MaBridgeStreamCreateOfflineNative,
+        MaBridgeStreamCreateOfflineDart>('ma_bridge_stream_create_offline');
+    streamSetOfflineClock = _lib.lookupFunction<
+            MaBridgeStreamSetOfflineClockNative,
+            MaBridgeStreamSetOfflineClockDart>(
+        'ma_bridge_stream_set_offline_clock');
+    streamPump =
+        _lib.lookupFunction<MaBridgeStreamPumpNative, MaBridgeStreamPumpDart>(
+            'ma_bridge_stream_pump');
+
     // Engine
     engineInit =
         _lib.lookupFunction<MaBridgeEngineInitNative, MaBridgeEngineInitDart>(
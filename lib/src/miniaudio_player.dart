@@ -2,15 +2,18 @@
 ///
 /// Contains:
 /// - MiniaudioPlayer: Low-latency pull-mode stream (for Emulators/VoIP)
+/// - MiniaudioRecorder: Low-latency capture stream (monitoring/voice chat)
 /// - MiniaudioEngine: High-level mixing engine (for Games/UI)
 /// - MiniaudioSound: Individual sound objects for the engine
 /// - MiniaudioSoundGroup: Grouping for volume control/effects
 /// - MiniaudioContext: Device enumeration
 library;
 
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:typed_data';
 import 'dart:io';
+import 'dart:isolate';
 
 import 'package:ffi/ffi.dart';
 import 'miniaudio_bindings.dart';
@@ -40,13 +43,353 @@ void _ensureLibraryLoaded() {
 
 enum MiniaudioDeviceType { playback, capture }
 
+/// Audio backends, in miniaudio's default priority order. Values match
+/// `ma_backend`.
+enum MiniaudioBackend {
+  wasapi,
+  dsound,
+  winmm,
+  coreaudio,
+  sndio,
+  audio4,
+  oss,
+  pulseaudio,
+  alsa,
+  jack,
+  aaudio,
+  opensl,
+  webaudio,
+  custom,
+  nullBackend,
+}
+
+/// One backend attempt made while initializing the shared context.
+class MiniaudioBackendProbe {
+  final MiniaudioBackend backend;
+
+  /// True for the backend the context ended up on.
+  final bool succeeded;
+  final Duration elapsed;
+
+  const MiniaudioBackendProbe(this.backend, this.succeeded, this.elapsed);
+}
+
+/// A native data format reported by a device. Zero fields mean "any".
+class MiniaudioDeviceFormat {
+  /// Sample format, or null for u8 and "any".
+  final MiniaudioFormat? format;
+  final int channels;
+  final int sampleRate;
+
+  /// Only available when the device is opened in exclusive mode.
+  final bool exclusiveMode;
+
+  const MiniaudioDeviceFormat(
+      this.format, this.channels, this.sampleRate, this.exclusiveMode);
+}
+
 class MiniaudioDeviceInfo {
   final String name;
   final Uint8List id; // Persistent ID data
   final int index;
 
+  /// The system's default device for this direction.
+  final bool isDefault;
+
+  /// Native formats reported by the backend (may be empty or "any").
+  final List<MiniaudioDeviceFormat> nativeFormats;
+
   MiniaudioDeviceInfo(
-      {required this.name, required this.id, required this.index});
+      {required this.name,
+      required this.id,
+      required this.index,
+      this.isDefault = false,
+      this.nativeFormats = const []});
+}
+
+/// Sample format of a [MiniaudioPlayer]'s FIFO.
+///
+/// The device runs in its native format; the audio callback converts from
+/// this format while draining. Use [f32] when the producer already renders
+/// float to skip quantizing in Dart.
+enum MiniaudioFormat {
+  s16(2, 2),
+  s24(3, 3), // Tightly packed
+  s32(4, 4),
+  f32(5, 4);
+
+  /// Matches `ma_bridge_format` / `ma_format`.
+  final int value;
+  final int bytesPerSample;
+
+  const MiniaudioFormat(this.value, this.bytesPerSample);
+}
+
+/// Backend and performance options for a device opened by the plugin.
+///
+/// The defaults are the native ones: low-latency profile, backend default
+/// period count, and no pre-silencing of the output buffer (every callback
+/// writes all frames). Set [noClip] when float output is known to stay in
+/// range, and [periods] to trade latency for robustness per platform.
+class MiniaudioDeviceConfig {
+  /// Backend buffer in periods; 0 keeps the backend default. On ALSA and
+  /// PulseAudio this sets the buffer size (period size * periods).
+  final int periods;
+
+  /// Use miniaudio's conservative profile instead of low latency.
+  final bool conservative;
+
+  final bool noPreSilencedOutputBuffer;
+
+  /// Skip the clip pass on float output.
+  final bool noClip;
+
+  /// Let the backend choose callback sizes (drops miniaudio's intermediate
+  /// buffer; the period size becomes a hint).
+  final bool noFixedSizedCallback;
+
+  final bool noDisableDenormals;
+
+  /// Exclusive share mode where supported (WASAPI, AAudio).
+  final bool exclusive;
+
+  final bool alsaNoMMap;
+  final bool alsaNoAutoFormat;
+  final bool alsaNoAutoChannels;
+  final bool alsaNoAutoResample;
+  final bool aaudioAllowSetBufferCapacity;
+
+  const MiniaudioDeviceConfig({
+    this.periods = 0,
+    this.conservative = false,
+    this.noPreSilencedOutputBuffer = true,
+    this.noClip = false,
+    this.noFixedSizedCallback = false,
+    this.noDisableDenormals = false,
+    this.exclusive = false,
+    this.alsaNoMMap = false,
+    this.alsaNoAutoFormat = false,
+    this.alsaNoAutoChannels = false,
+    this.alsaNoAutoResample = false,
+    this.aaudioAllowSetBufferCapacity = false,
+  });
+
+  // The native options apply to the next device opened, so each owner sets
+  // them (or restores the defaults) right before creating its device.
+  static void _use(MiniaudioDeviceConfig? config) {
+    if (config == null) {
+      _bindings!.setDeviceConfig(nullptr);
+      return;
+    }
+    final native = calloc<MaBridgeDeviceConfig>();
+    try {
+      native.ref
+        ..periods = config.periods
+        ..conservative = config.conservative ? 1 : 0
+        ..noPreSilencedOutputBuffer = config.noPreSilencedOutputBuffer ? 1 : 0
+        ..noClip = config.noClip ? 1 : 0
+        ..noFixedSizedCallback = config.noFixedSizedCallback ? 1 : 0
+        ..noDisableDenormals = config.noDisableDenormals ? 1 : 0
+        ..exclusive = config.exclusive ? 1 : 0
+        ..alsaNoMMap = config.alsaNoMMap ? 1 : 0
+        ..alsaNoAutoFormat = config.alsaNoAutoFormat ? 1 : 0
+        ..alsaNoAutoChannels = config.alsaNoAutoChannels ? 1 : 0
+        ..alsaNoAutoResample = config.alsaNoAutoResample ? 1 : 0
+        ..aaudioAllowSetBufferCapacity =
+            config.aaudioAllowSetBufferCapacity ? 1 : 0;
+      _bindings!.setDeviceConfig(native);
+    } finally {
+      calloc.free(native);
+    }
+  }
+}
+
+/// Virtual clock of an offline [MiniaudioPlayer]: no device is opened, and
+/// periods run through the same FIFO, rate control and resampler as on a
+/// device, timestamped as if they were played at [MiniaudioPlayer.sampleRate].
+///
+/// [MiniaudioPlayer.start] runs them on a pump thread, as fast as possible
+/// ([speed] 0) or at [speed] times real time; [MiniaudioPlayer.pump] runs
+/// them on the calling thread. Runs with the same input, [jitter] and [seed]
+/// are identical, which makes it suitable for tests and CI without audio
+/// hardware.
+class MiniaudioOfflineClock {
+  /// Virtual seconds per real second for the pump thread; 0 runs as fast as
+  /// possible.
+  final double speed;
+
+  /// Maximum random offset (either way) of each period's timestamp, to
+  /// exercise rate control and trace statistics. Clamped to half a period.
+  final Duration jitter;
+
+  /// Seed of the jitter sequence.
+  final int seed;
+
+  /// Format of the simulated device buffer (null for the player's format).
+  final MiniaudioFormat? deviceFormat;
+
+  const MiniaudioOfflineClock({
+    this.speed = 0,
+    this.jitter = Duration.zero,
+    this.seed = 1,
+    this.deviceFormat,
+  });
+}
+
+/// Resampler used when [MiniaudioPlayer.inputSampleRate] differs from the
+/// device rate.
+///
+/// [linear] is cheapest but aliases, audibly so when downsampling. The sinc
+/// modes are band-limited (8, 16 or 32 taps) and add taps / 2 input frames
+/// of latency.
+enum MiniaudioResampleQuality {
+  linear(0),
+  low(1),
+  medium(2),
+  high(3);
+
+  /// Matches `ma_bridge_resample_quality`.
+  final int value;
+
+  const MiniaudioResampleQuality(this.value);
+}
+
+/// Space reserved in the player's ring by [MiniaudioPlayer.reserve] (s16)
+/// or [MiniaudioPlayer.reserveFloat32] (f32), or captured audio exposed by
+/// [MiniaudioRecorder.acquire] / [MiniaudioRecorder.acquireFloat32].
+///
+/// [first] and [second] are views straight into ring memory (interleaved
+/// samples). Fill (or read) [first], then [second], and hand them back with
+/// [MiniaudioPlayer.commit] or [MiniaudioRecorder.release]. The views must
+/// not be used after that.
+class MiniaudioFifoReservation<T extends TypedData> {
+  final T first;
+  final T second;
+
+  /// Total frames reserved across both segments.
+  final int frames;
+
+  MiniaudioFifoReservation._(this.first, this.second, this.frames);
+}
+
+/// Glitch counters of a [MiniaudioPlayer], read from shared memory.
+///
+/// Counters are monotonic; diff two snapshots for rates. Fill extremes are
+/// in frames since the last [MiniaudioPlayer.resetStats].
+class MiniaudioStreamStats {
+  final int framesConsumed;
+  final int callbackCount;
+  final int underrunEvents;
+  final int underrunFrames;
+  final int overrunEvents;
+  final int overrunFrames;
+  final int fillMinFrames;
+  final int fillMaxFrames;
+
+  const MiniaudioStreamStats({
+    this.framesConsumed = 0,
+    this.callbackCount = 0,
+    this.underrunEvents = 0,
+    this.underrunFrames = 0,
+    this.overrunEvents = 0,
+    this.overrunFrames = 0,
+    this.fillMinFrames = 0,
+    this.fillMaxFrames = 0,
+  });
+
+  /// Consistent snapshot of a native stats block; retries while the audio
+  /// thread is mid-update. The sequence is loaded natively, with the
+  /// acquire ordering plain Dart loads lack on weakly ordered CPUs (ARM).
+  factory MiniaudioStreamStats._read(Pointer<MaBridgeStreamStats> stats) {
+    final s = stats.ref;
+    while (true) {
+      final seq = _bindings!.streamStatsSequence(stats);
+      if (seq.isOdd) continue;
+      final snapshot = MiniaudioStreamStats(
+        framesConsumed: s.framesConsumed,
+        callbackCount: s.callbackCount,
+        underrunEvents: s.underrunEvents,
+        underrunFrames: s.underrunFrames,
+        overrunEvents: s.overrunEvents,
+        overrunFrames: s.overrunFrames,
+        fillMinFrames: s.fillMinFrames,
+        fillMaxFrames: s.fillMaxFrames,
+      );
+      if (_bindings!.streamStatsSequence(stats) == seq) return snapshot;
+    }
+  }
+}
+
+/// One audio callback as recorded by the callback trace.
+class MiniaudioCallbackTrace {
+  final int startNs;
+  final int endNs;
+  final int framesRequested;
+  final int framesDelivered;
+
+  const MiniaudioCallbackTrace(
+      this.startNs, this.endNs, this.framesRequested, this.framesDelivered);
+
+  int get durationNs => endNs - startNs;
+}
+
+/// Callback timing aggregated over everything drained since the last reset.
+///
+/// [load] is callback time divided by the period it had to fill.
+/// [jitterHistogram] bins |interval error|: bin 0 is < 1 us, bin i covers
+/// [2^(i-1), 2^i) us and the last bin is open-ended.
+class MiniaudioTraceSummary {
+  final int callbacks;
+  final int dropped;
+  final double loadMean;
+  final double loadMax;
+  final int intervalErrorMinNs;
+  final int intervalErrorMaxNs;
+  final List<int> jitterHistogram;
+
+  const MiniaudioTraceSummary({
+    required this.callbacks,
+    required this.dropped,
+    required this.loadMean,
+    required this.loadMax,
+    required this.intervalErrorMinNs,
+    required this.intervalErrorMaxNs,
+    required this.jitterHistogram,
+  });
+}
+
+/// Playback clock sample taken at entry of an audio callback.
+///
+/// The frame at [framePosition] (content frames consumed from the FIFO)
+/// becomes audible at about [hostTimeNs] + [outputLatencyFrames] worth of
+/// time. [hostTimeNs] is on the [MiniaudioPlayer.hostTimeNs] clock.
+class MiniaudioTimestamp {
+  final int framePosition;
+  final int hostTimeNs;
+  final int outputLatencyFrames;
+  final int sampleRate;
+
+  const MiniaudioTimestamp(this.framePosition, this.hostTimeNs,
+      this.outputLatencyFrames, this.sampleRate);
+
+  /// Host time at which the frame at [framePosition] reaches the speaker.
+  int get presentationTimeNs =>
+      hostTimeNs + outputLatencyFrames * 1000000000 ~/ sampleRate;
+}
+
+/// Capture clock sample of a [MiniaudioRecorder].
+class MiniaudioCaptureTimestamp {
+  final int framePosition;
+  final int hostTimeNs;
+  final int inputLatencyFrames;
+  final int sampleRate;
+
+  const MiniaudioCaptureTimestamp(this.framePosition, this.hostTimeNs,
+      this.inputLatencyFrames, this.sampleRate);
+
+  /// Host time at which the frame at [framePosition] hit the microphone.
+  int get captureTimeNs =>
+      hostTimeNs - inputLatencyFrames * 1000000000 ~/ sampleRate;
 }
 
 // --- Context (Enumeration) ---
@@ -62,46 +405,235 @@ class MiniaudioContext {
     return _getDevices(MiniaudioDeviceType.capture);
   }
 
+  /// Re-enumerate on the next call (e.g. after a device was plugged in).
+  /// The device lists are otherwise probed once and cached natively.
+  static void refreshDevices() {
+    _ensureLibraryLoaded();
+    _bindings!.contextInvalidateDevices();
+  }
+
+  /// Try only [backends], in this order, when the shared context is
+  /// created. Call before anything else touches audio (enumeration,
+  /// players, engine); an empty list restores the default order. Backends
+  /// not compiled in are skipped. Returns false once the context exists or
+  /// when none of [backends] is available.
+  static bool setBackends(List<MiniaudioBackend> backends) {
+    _ensureLibraryLoaded();
+    if (backends.isEmpty) {
+      return _bindings!.setBackends(nullptr, 0) >= 0;
+    }
+    final native = calloc<Int32>(backends.length);
+    try {
+      for (int i = 0; i < backends.length; i++) {
+        native[i] = backends[i].index;
+      }
+      return _bindings!.setBackends(native, backends.length) > 0;
+    } finally {
+      calloc.free(native);
+    }
+  }
+
+  /// Backend the shared context runs on, or null before it is created.
+  static MiniaudioBackend? get backend {
+    _ensureLibraryLoaded();
+    final value = _bindings!.contextGetBackend();
+    return (value >= 0 && value < MiniaudioBackend.values.length)
+        ? MiniaudioBackend.values[value]
+        : null;
+  }
+
+  /// Backends tried by the context init, with the time each one took.
+  static List<MiniaudioBackendProbe> get backendProbes {
+    _ensureLibraryLoaded();
+    final count = _bindings!.contextGetBackendProbes(nullptr, 0);
+    if (count <= 0) return [];
+    final probes = calloc<MaBridgeBackendProbe>(count);
+    try {
+      final filled = _bindings!.contextGetBackendProbes(probes, count);
+      return [
+        for (int i = 0; i < filled && i < count; i++)
+          MiniaudioBackendProbe(
+            MiniaudioBackend.values[probes[i].backend],
+            probes[i].result == 0,
+            Duration(microseconds: probes[i].elapsedNs ~/ 1000),
+          ),
+      ];
+    } finally {
+      calloc.free(probes);
+    }
+  }
+
+  static const int _exclusiveModeFlag = 2; // MA_DATA_FORMAT_FLAG_EXCLUSIVE_MODE
+
+  static MiniaudioFormat? _formatFromValue(int value) {
+    for (final format in MiniaudioFormat.values) {
+      if (format.value == value) return format;
+    }
+    return null;
+  }
+
   static List<MiniaudioDeviceInfo> _getDevices(MiniaudioDeviceType type) {
     _ensureLibraryLoaded();
     final typeInt = type == MiniaudioDeviceType.playback ? 0 : 1;
-    final count = _bindings!.contextGetDeviceCount(typeInt);
-
-    final List<MiniaudioDeviceInfo> devices = [];
-    final nameBuffer = calloc<Uint8>(256).cast<Utf8>();
-    const idBufferSize = 256;
-    final idBuffer = calloc<Uint8>(idBufferSize);
+    final count = _bindings!.contextGetDevices(typeInt, nullptr, 0);
+    if (count <= 0) return [];
 
+    // One native call for the whole list, served from the cached snapshot
+    final records = calloc<MaBridgeDeviceRecord>(count);
     try {
-      for (int i = 0; i < count; i++) {
-        final result = _bindings!.contextGetDeviceInfo(
-            typeInt, i, nameBuffer, 256, idBuffer.cast(), idBufferSize);
-        if (result == 0) {
-          // Copy ID data to Dart-managed memory
-          final idData = Uint8List.fromList(idBuffer.asTypedList(idBufferSize));
-
-          devices.add(MiniaudioDeviceInfo(
-            name: nameBuffer.toDartString(),
-            id: idData,
-            index: i,
+      final filled = _bindings!.contextGetDevices(typeInt, records, count);
+      final List<MiniaudioDeviceInfo> devices = [];
+      for (int i = 0; i < filled && i < count; i++) {
+        final record = records[i];
+        final nameBytes = <int>[];
+        for (int c = 0; c < 256 && record.name[c] != 0; c++) {
+          nameBytes.add(record.name[c]);
+        }
+        final id = Uint8List(256);
+        for (int j = 0; j < 256; j++) {
+          id[j] = record.id[j];
+        }
+        final formats = <MiniaudioDeviceFormat>[];
+        for (int f = 0; f < record.formatCount; f++) {
+          final native = record.formats[f];
+          formats.add(MiniaudioDeviceFormat(
+            _formatFromValue(native.format),
+            native.channels,
+            native.sampleRate,
+            (native.flags & _exclusiveModeFlag) != 0,
           ));
         }
+
+        devices.add(MiniaudioDeviceInfo(
+          name: utf8.decode(nameBytes, allowMalformed: true),
+          id: id,
+          index: i,
+          isDefault: record.isDefault != 0,
+          nativeFormats: formats,
+        ));
       }
+      return devices;
     } finally {
-      calloc.free(nameBuffer);
-      calloc.free(idBuffer);
+      calloc.free(records);
     }
-    return devices;
+  }
+}
+
+// --- Logging ---
+
+/// Severity of a native log message.
+enum MiniaudioLogLevel {
+  debug(0),
+  info(1),
+  warning(2),
+  error(3),
+  none(4);
+
+  final int value;
+  const MiniaudioLogLevel(this.value);
+}
+
+/// One message from the native bridge.
+class MiniaudioLogRecord {
+  final MiniaudioLogLevel level;
+
+  /// Monotonic host time of the message, in nanoseconds (the clock of
+  /// [MiniaudioTimestamp]).
+  final int hostTimeNs;
+
+  final String message;
+
+  const MiniaudioLogRecord(this.level, this.hostTimeNs, this.message);
+
+  @override
+  String toString() => '[${level.name}] $message';
+}
+
+/// The native bridge's log. Messages are queued without locking (so audio
+/// and producer threads never wait on it) and delivered by a background
+/// thread, to stdout and/or [records]. If the queue overflows, messages are
+/// dropped and counted in [dropped].
+class MiniaudioLog {
+  static ReceivePort? _port;
+
+  /// Minimum level recorded (default [MiniaudioLogLevel.info]).
+  static set level(MiniaudioLogLevel level) {
+    _ensureLibraryLoaded();
+    _bindings!.logSetLevel(level.value);
+  }
+
+  /// Print messages to stdout (default true).
+  static set printToStdout(bool enabled) {
+    _ensureLibraryLoaded();
+    _bindings!.logSetStdout(enabled ? 1 : 0);
+  }
+
+  /// Messages delivered from now on. Replaces any previous stream.
+  static Stream<MiniaudioLogRecord> records() {
+    stopRecords();
+    _ensureLibraryLoaded();
+    final port = ReceivePort();
+    _bindings!.logSetPort(
+        NativeApi.postCObject.cast(), port.sendPort.nativePort);
+    _port = port;
+    return port.map((message) {
+      final fields = message as List;
+      final level = fields[0] as int;
+      return MiniaudioLogRecord(
+        MiniaudioLogLevel.values[level.clamp(0, 3)],
+        fields[1] as int,
+        fields[2] as String,
+      );
+    });
+  }
+
+  /// Stop [records] and close its stream.
+  static void stopRecords() {
+    final port = _port;
+    if (port == null) return;
+    _bindings!.logSetPort(nullptr, 0);
+    port.close();
+    _port = null;
+  }
+
+  /// Messages dropped because the queue was full, since the process started.
+  static int get dropped {
+    _ensureLibraryLoaded();
+    return _bindings!.logGetDropped();
+  }
+
+  /// Deliver everything queued so far, on the calling thread.
+  static void flush() {
+    _ensureLibraryLoaded();
+    _bindings!.logFlush();
   }
 }
 
 // --- Player (Device Stream) ---
 
 /// Low-latency audio player using miniaudio with pull-mode callbacks.
+///
+/// Each player owns a native stream (device, FIFO and resampler), so several
+/// players can run at once.
 class MiniaudioPlayer {
-  late final Pointer<Int16> _fifoPtr;
-  late final Pointer<Int32> _readPos;
-  late final Pointer<Int32> _writePos;
+  Pointer<MaBridgeStream> _stream = nullptr;
+  Pointer<MaBridgeStreamStats> _stats = nullptr;
+
+  // Callback trace out-params (allocated on first use)
+  static const int _traceCapacity = 1024; // MA_BRIDGE_TRACE_CAPACITY
+  Pointer<MaBridgeCallbackTrace> _traceBuffer = nullptr;
+  Pointer<MaBridgeTraceSummary> _traceSummary = nullptr;
+  Pointer<Uint64> _timestampPosition = nullptr;
+  Pointer<Uint64> _timestampHostNs = nullptr;
+  ReceivePort? _lowWaterPort;
+  late final Pointer<Uint8> _fifoPtr;
+  late final Pointer<MaBridgeFifoPositions> _fifoPositions;
+
+  // Out-params for ma_bridge_fifo_reserve (allocated once)
+  late final Pointer<Pointer<Void>> _reservePtr1;
+  late final Pointer<Pointer<Void>> _reservePtr2;
+  late final Pointer<Int32> _reserveLen1;
+  late final Pointer<Int32> _reserveLen2;
 
   final int sampleRate;
   final int channels;
@@ -109,8 +641,49 @@ class MiniaudioPlayer {
   final int fifoCapacityFrames;
   final Uint8List? deviceId;
   final int? inputSampleRate; // Source rate (e.g. 48002Hz)
+  final MiniaudioFormat format;
+
+  /// Resample in the audio callback instead of on [write]: the FIFO holds
+  /// [inputSampleRate] audio, the producer does no conversion work, and rate
+  /// control reacts every period rather than every write.
+  final bool pullResampling;
+
+  final MiniaudioResampleQuality resampleQuality;
 
-  int get _fifoCapacitySamples => fifoCapacityFrames * channels;
+  /// Optional native producer (e.g. an emulator core in the same process)
+  /// that renders each period straight into the device buffer on the audio
+  /// thread. The FIFO still fills whatever it does not render.
+  final Pointer<NativeFunction<MaBridgeRenderProcNative>>? renderCallback;
+
+  /// Passed to [renderCallback] or [processCallback].
+  final Pointer<Void>? renderUserData;
+
+  /// Open a full-duplex device: input and output share each period, and the
+  /// captured side is available through [input].
+  final bool duplex;
+
+  /// Capture device of a [duplex] player (null for the default input).
+  final Uint8List? captureDeviceId;
+
+  /// Optional native duplex callback: turns each period's input into output
+  /// on the audio thread, for one-period monitoring and effects. Implies
+  /// [duplex]; the FIFO fills whatever it does not write.
+  final Pointer<NativeFunction<MaBridgeDuplexProcNative>>? processCallback;
+
+  MiniaudioRecorder? _input;
+
+  /// Backend and performance options for this player's device.
+  final MiniaudioDeviceConfig? deviceConfig;
+
+  /// Run without a device on a virtual clock (see [MiniaudioOfflineClock]).
+  /// Not combined with [renderCallback] or [duplex].
+  final MiniaudioOfflineClock? offlineClock;
+
+  /// Ring capacity in samples: exactly [fifoCapacityFrames] frames, so a
+  /// frame never straddles the end of the ring. The native side wraps with a
+  /// mask when this is a power of two (power-of-two frames and channels) and
+  /// with a modulo otherwise.
+  late final int _fifoCapacitySamples = fifoCapacityFrames * channels;
 
   bool _initialized = false;
   bool _started = false;
@@ -123,7 +696,20 @@ class MiniaudioPlayer {
     this.fifoCapacityFrames = 8192,
     this.deviceId, // Optional specific device
     this.inputSampleRate,
-  }) {
+    this.format = MiniaudioFormat.s16,
+    this.pullResampling = false,
+    this.resampleQuality = MiniaudioResampleQuality.linear,
+    this.renderCallback,
+    this.renderUserData,
+    bool duplex = false,
+    this.captureDeviceId,
+    this.processCallback,
+    this.deviceConfig,
+    this.offlineClock,
+  }) : duplex = duplex || processCallback != null {
+    if (offlineClock != null && (renderCallback != null || this.duplex)) {
+      throw ArgumentError('An offline player only plays from the FIFO');
+    }
     _ensureLibraryLoaded();
     try {
       _allocateBuffers();
@@ -136,47 +722,134 @@ class MiniaudioPlayer {
   }
 
   void _allocateBuffers() {
-    _fifoPtr = calloc<Int16>(_fifoCapacitySamples);
-    _readPos = calloc<Int32>();
-    _writePos = calloc<Int32>();
-    _readPos.value = 0;
-    _writePos.value = 0;
+    _fifoPtr = calloc<Uint8>(_fifoCapacitySamples * format.bytesPerSample);
+    _fifoPositions = calloc<MaBridgeFifoPositions>();
+    _reservePtr1 = calloc<Pointer<Void>>();
+    _reservePtr2 = calloc<Pointer<Void>>();
+    _reserveLen1 = calloc<Int32>();
+    _reserveLen2 = calloc<Int32>();
   }
 
-  void _initDevice() {
-    Pointer<Void> deviceIdPtr = nullptr;
+  // Native copy of a device ID, or nullptr for the default device
+  static Pointer<Void> _copyDeviceId(Uint8List? id) {
+    if (id == null) return nullptr;
+    final ptr = calloc<Uint8>(id.length);
+    ptr.asTypedList(id.length).setAll(0, id);
+    return ptr.cast();
+  }
 
-    // Allocate native memory for the device ID if provided
-    if (deviceId != null) {
-      final ptr = calloc<Uint8>(deviceId!.length);
-      final list = ptr.asTypedList(deviceId!.length);
-      list.setAll(0, deviceId!);
-      deviceIdPtr = ptr.cast();
-    }
+  void _initDevice() {
+    // Allocate native memory for the device IDs if provided
+    final deviceIdPtr = _copyDeviceId(deviceId);
+    final captureDeviceIdPtr =
+        duplex ? _copyDeviceId(captureDeviceId) : nullptr;
 
     try {
-      final result =
-          _bindings!.init(deviceIdPtr, sampleRate, channels, bufferFrames);
-      if (result != 0) {
-        throw Exception('Failed to initialize miniaudio device: $result');
+      MiniaudioDeviceConfig._use(deviceConfig);
+      final clock = offlineClock;
+      if (clock != null) {
+        _stream = _bindings!.streamCreateOffline(sampleRate, channels,
+            bufferFrames, format.value, clock.deviceFormat?.value ?? 0);
+        if (_stream != nullptr) {
+          _bindings!.streamSetOfflineClock(
+              _stream, clock.speed, clock.jitter.inMicroseconds, clock.seed);
+        }
+      } else if (duplex) {
+        _stream = _bindings!.streamCreateDuplex(
+            deviceIdPtr,
+            captureDeviceIdPtr,
+            sampleRate,
+            channels,
+            bufferFrames,
+            format.value,
+            processCallback ?? nullptr,
+            renderUserData ?? nullptr);
+      } else {
+        _stream = renderCallback != null
+            ? _bindings!.streamCreateWithRenderCallback(
+                deviceIdPtr,
+                sampleRate,
+                channels,
+                bufferFrames,
+                format.value,
+                renderCallback!,
+                renderUserData ?? nullptr)
+            : _bindings!.streamCreate(
+                deviceIdPtr, sampleRate, channels, bufferFrames, format.value);
+      }
+      if (_stream == nullptr) {
+        throw Exception('Failed to initialize miniaudio device');
       }
+      _stats = _bindings!.streamGetStats(_stream);
       print(
           "[MiniaudioPlayer] Device Initialized. Rate: $sampleRate, Channels: $channels");
 
       // Initialize Resampler if needed
       if (inputSampleRate != null && inputSampleRate != sampleRate) {
-        final res = _bindings!.initResampler(inputSampleRate!, sampleRate);
+        _bindings!.streamSetResampleQuality(_stream, resampleQuality.value);
+        final res = pullResampling
+            ? _bindings!.streamInitPullResampler(_stream, inputSampleRate!)
+            : _bindings!
+                .streamInitResampler(_stream, inputSampleRate!, sampleRate);
         if (res != 0) {
           print("[MiniaudioPlayer] WARNING: Failed to initialize resampler!");
         }
       }
 
-      _bindings!.setFifo(_fifoPtr, _fifoCapacitySamples, _readPos, _writePos);
+      _bindings!.streamSetFifo(
+          _stream, _fifoPtr.cast(), _fifoCapacitySamples, _fifoPositions);
       _initialized = true;
+      if (duplex) {
+        _input = MiniaudioRecorder._attached(this);
+      }
     } finally {
       if (deviceIdPtr != nullptr) {
         calloc.free(deviceIdPtr);
       }
+      if (captureDeviceIdPtr != nullptr) {
+        calloc.free(captureDeviceIdPtr);
+      }
+    }
+  }
+
+  /// Captured side of a [duplex] player (null otherwise). It shares this
+  /// player's device: start, stop and dispose go through the player.
+  MiniaudioRecorder? get input => _input;
+
+  /// Input-to-output latency of a [duplex] player in frames: input latency
+  /// plus output latency, the delay [processCallback] output is heard with.
+  int get roundTripLatencyFrames => (_initialized && duplex)
+      ? _bindings!.streamGetInputLatencyFrames(_stream) +
+          _bindings!.streamGetOutputLatencyFrames(_stream)
+      : 0;
+
+  /// Run [periods] periods of an offline player on the calling thread, as
+  /// fast as possible. The rendered audio (interleaved, in the clock's
+  /// device format) is copied to [output] when given, which must hold
+  /// periods * [bufferFrames] frames. Not while started.
+  /// Returns the frames taken from the FIFO; the rest was silence.
+  int pump(int periods, {Uint8List? output}) {
+    if (!_initialized || offlineClock == null) {
+      throw StateError('MiniaudioPlayer is not offline');
+    }
+    if (periods <= 0) return 0;
+    final bytes = periods *
+        bufferFrames *
+        channels *
+        (offlineClock!.deviceFormat ?? format).bytesPerSample;
+    if (output != null && output.length < bytes) {
+      throw ArgumentError.value(output.length, 'output', 'Too short');
+    }
+    final native = output != null ? calloc<Uint8>(bytes) : nullptr;
+    try {
+      final frames = _bindings!.streamPump(_stream, periods, native.cast());
+      if (frames < 0) {
+        throw StateError('Cannot pump a started player');
+      }
+      output?.setAll(0, native.asTypedList(bytes));
+      return frames;
+    } finally {
+      if (native != nullptr) calloc.free(native);
     }
   }
 
@@ -189,7 +862,7 @@ class MiniaudioPlayer {
       print("[MiniaudioPlayer] already started");
       return;
     }
-    if (_bindings!.start() != 0) {
+    if (_bindings!.streamStart(_stream) != 0) {
       throw Exception('Failed to start audio playback');
     }
     _started = true;
@@ -200,7 +873,7 @@ class MiniaudioPlayer {
     if (!_initialized) {
       return;
     }
-    _bindings!.setVolume(volume);
+    _bindings!.streamSetVolume(_stream, volume);
   }
 
   void setLogEnabled(bool enabled) {
@@ -210,139 +883,670 @@ class MiniaudioPlayer {
     _bindings!.setLogEnabled(enabled ? 1 : 0);
   }
 
+  /// Playback speed factor (1.0 = normal). Applied by the resampler on top
+  /// of the source/device rate ratio and independent of rate control, so it
+  /// sticks across writes. Needs [inputSampleRate] to differ from
+  /// [sampleRate] (the resampler is skipped otherwise).
   void setPlaybackSpeed(double speed) {
     if (!_initialized) return;
+    _bindings!.streamSetPlaybackSpeed(_stream, speed);
+  }
 
-    // Calculate ratio: device / (input * speed)
-    // e.g. Device 48000, Input 48000, Speed 1.0 => Ratio 1.0
-    // e.g. Device 48000, Input 48000, Speed 2.0 => Ratio 0.5 (need to squeeze 2x input into 1x output time -> consume input 2x faster -> actually ratio is input_consumed / output_generated)
-
-    // Wait, ratio in miniaudio ma_resampler_set_rate_ratio:
-    // "ratio of input sample rate to output sample rate" -> input / output ?
-    // ma_resampler_init docs: "ratio = sampleRateIn / sampleRateOut"
-    // NO. miniaudio docs: "ratio = in / out".
-    // Let's verify. ma_resampler_config_init takes in, out.
-    // ratio = (double)config.sampleRateIn / (double)config.sampleRateOut;
-
-    // If we want 2x speed (pitch up), we want to consume 2x frames for every 1x output frame.
-    // So effective input rate is doubled?
-    // No, effective ratio is doubled.
-    // Ratio = InputFrames / OutputFrames
-
-    double baseRatio;
-    if (inputSampleRate != null) {
-      baseRatio = inputSampleRate! / sampleRate;
-    } else {
-      baseRatio = 1.0;
-    }
-
-    // speed 1.0 -> ratio = baseRatio
-    // speed 2.0 -> ratio = baseRatio * speed (Consume 2x input for same output)
-
-    _bindings!.setResamplingRatio(baseRatio * speed);
+  /// Configure dynamic rate control: the resampling ratio is nudged by at
+  /// most [maxSkew] (a fraction) to hold the FIFO at [targetLatency]
+  /// (default: half the FIFO). A [maxSkew] of 0 disables it. Like
+  /// [setPlaybackSpeed], it needs [inputSampleRate] to differ from
+  /// [sampleRate]: with no resampler there is no ratio to skew, so it has no
+  /// effect on a same-rate stream (e.g. 48 kHz in, 48 kHz out).
+  void setRateControl({Duration? targetLatency, double maxSkew = 0.005}) {
+    if (!_initialized) return;
+    final targetFrames = targetLatency == null
+        ? 0
+        : targetLatency.inMicroseconds * sampleRate ~/ 1000000;
+    _bindings!.streamSetRateControl(_stream, targetFrames, maxSkew);
   }
 
+  /// Resampling ratio (input / output) applied to the most recent write.
+  double get resamplingRatio =>
+      _initialized ? _bindings!.streamGetResamplingRatio(_stream) : 0.0;
+
   void stop() {
     print("[MiniaudioPlayer] stop() called");
     if (!_started) {
       return;
     }
-    _bindings!.stop();
+    _bindings!.streamStop(_stream);
     _started = false;
     print("[MiniaudioPlayer] stopped");
   }
 
-  int write(Pointer<Int16> data, int frames) {
+  /// Write [frames] interleaved frames in the player's [format].
+  int write(Pointer<NativeType> data, int frames) {
     if (!_initialized) {
       return 0;
     }
 
     // Use Native C bridge for safe, atomic write with barriers
-    return _bindings!.writePcmFrames(data, frames);
-  }
-
-  // Deprecated: pure-Dart manual implementation
-  // int write(Pointer<Int16> data, int frames) {
-  //   if (!_initialized) {
-  //     return 0;
-  //   }
-  //   final samplesToWrite = frames * channels;
-  //   final writeVal = _writePos.value;
-  //   final readVal = _readPos.value;
-
-  //   int freeSpace;
-  //   if (writeVal >= readVal) {
-  //     freeSpace = _fifoCapacitySamples - (writeVal - readVal) - 1;
-  //   } else {
-  //     freeSpace = readVal - writeVal - 1;
-  //   }
-
-  //   final actualSamples =
-  //       samplesToWrite <= freeSpace ? samplesToWrite : freeSpace;
-  //   if (actualSamples == 0) {
-  //     return 0;
-  //   }
-
-  //   for (int i = 0; i < actualSamples; i++) {
-  //     _fifoPtr[(writeVal + i) % _fifoCapacitySamples] = data[i];
-  //   }
-  //   _writePos.value = (writeVal + actualSamples) % _fifoCapacitySamples;
-
-  //   // Debug Log (Throttled)
-  //   if ((_writePos.value % 1000) < 100) {
-  //     // print("[MiniaudioPlayer] Wrote $actualSamples samples. FIFO available: ${fifoAvailable}");
-  //   }
-
-  //   return actualSamples ~/ channels;
-  // }
+    return _bindings!.streamWritePcmFrames(_stream, data.cast(), frames);
+  }
+
+  void _checkFormat(MiniaudioFormat expected) {
+    if (format != expected) {
+      throw StateError('MiniaudioPlayer FIFO format is ${format.name}, '
+          'not ${expected.name}');
+    }
+  }
+
+  /// Reserve up to [frames] frames of ring memory to render into in place,
+  /// avoiding the copy made by [write]. Publish them with [commit].
+  /// Requires [MiniaudioFormat.s16].
+  MiniaudioFifoReservation<Int16List> reserve(int frames) {
+    _checkFormat(MiniaudioFormat.s16);
+    if (!_initialized) {
+      return MiniaudioFifoReservation._(Int16List(0), Int16List(0), 0);
+    }
+
+    final reserved = _reserveSegments(frames);
+    final len1 = _reserveLen1.value * channels;
+    final len2 = _reserveLen2.value * channels;
+    return MiniaudioFifoReservation._(
+      len1 > 0
+          ? _reservePtr1.value.cast<Int16>().asTypedList(len1)
+          : Int16List(0),
+      len2 > 0
+          ? _reservePtr2.value.cast<Int16>().asTypedList(len2)
+          : Int16List(0),
+      reserved,
+    );
+  }
+
+  /// Float counterpart of [reserve]. Requires [MiniaudioFormat.f32].
+  MiniaudioFifoReservation<Float32List> reserveFloat32(int frames) {
+    _checkFormat(MiniaudioFormat.f32);
+    if (!_initialized) {
+      return MiniaudioFifoReservation._(Float32List(0), Float32List(0), 0);
+    }
+
+    final reserved = _reserveSegments(frames);
+    final len1 = _reserveLen1.value * channels;
+    final len2 = _reserveLen2.value * channels;
+    return MiniaudioFifoReservation._(
+      len1 > 0
+          ? _reservePtr1.value.cast<Float>().asTypedList(len1)
+          : Float32List(0),
+      len2 > 0
+          ? _reservePtr2.value.cast<Float>().asTypedList(len2)
+          : Float32List(0),
+      reserved,
+    );
+  }
+
+  int _reserveSegments(int frames) => _bindings!.streamFifoReserve(
+      _stream, frames, _reservePtr1, _reserveLen1, _reservePtr2, _reserveLen2);
+
+  /// Make [frames] frames written into the last [reserve] audible.
+  /// Returns the number of frames committed.
+  int commit(int frames) {
+    if (!_initialized) {
+      return 0;
+    }
+    return _bindings!.streamFifoCommit(_stream, frames);
+  }
 
   int writeList(List<int> samples) {
     if (!_initialized) {
       return 0;
     }
 
-    final writeVal = _writePos.value;
-    final readVal = _readPos.value;
-    int freeSpace = (writeVal >= readVal)
-        ? _fifoCapacitySamples - (writeVal - readVal) - 1
-        : readVal - writeVal - 1;
+    // Copy straight into ring memory; the bridge publishes the write
+    // position on commit so the audio thread never sees partial data.
+    final reservation = reserve(samples.length ~/ channels);
+    if (reservation.frames == 0) {
+      return 0;
+    }
+    final first = reservation.first;
+    final second = reservation.second;
+    first.setRange(0, first.length, samples);
+    if (second.isNotEmpty) {
+      second.setRange(0, second.length, samples, first.length);
+    }
+    return commit(reservation.frames);
+  }
 
-    final actualSamples =
-        samples.length <= freeSpace ? samples.length : freeSpace;
-    if (actualSamples == 0) {
+  /// Float counterpart of [writeList]. Requires [MiniaudioFormat.f32].
+  int writeFloat32List(List<double> samples) {
+    if (!_initialized) {
       return 0;
     }
 
-    for (int i = 0; i < actualSamples; i++) {
-      _fifoPtr[(writeVal + i) % _fifoCapacitySamples] = samples[i];
+    final reservation = reserveFloat32(samples.length ~/ channels);
+    if (reservation.frames == 0) {
+      return 0;
+    }
+    final first = reservation.first;
+    final second = reservation.second;
+    first.setRange(0, first.length, samples);
+    if (second.isNotEmpty) {
+      second.setRange(0, second.length, samples, first.length);
+    }
+    return commit(reservation.frames);
+  }
+
+  int get framesConsumed => _initialized ? stats.framesConsumed : 0;
+
+  /// Snapshot of the stream's glitch counters. Reads shared memory, plus a
+  /// leaf call per sequence load; retries while the audio thread is
+  /// mid-update.
+  MiniaudioStreamStats get stats {
+    if (!_initialized || _stats == nullptr) {
+      return const MiniaudioStreamStats();
+    }
+    return MiniaudioStreamStats._read(_stats);
+  }
+
+  /// Restart min/max fill tracking. Counters are not cleared.
+  void resetStats() {
+    if (_initialized) _bindings!.streamResetStats(_stream);
+  }
+
+  /// Record entry/exit time of every audio callback (off by default).
+  /// Drain regularly with [drainTrace] or [traceSummary]; records that do not
+  /// fit in the native ring are dropped, never waited for.
+  void setTraceEnabled(bool enabled) {
+    if (_initialized) {
+      _bindings!.streamSetTraceEnabled(_stream, enabled ? 1 : 0);
+    }
+  }
+
+  /// Take the pending callback records (also folded into [traceSummary]).
+  List<MiniaudioCallbackTrace> drainTrace() {
+    if (!_initialized) return const [];
+    if (_traceBuffer == nullptr) {
+      _traceBuffer = calloc<MaBridgeCallbackTrace>(_traceCapacity);
     }
-    _writePos.value = (writeVal + actualSamples) % _fifoCapacitySamples;
-    return actualSamples ~/ channels;
+    final count =
+        _bindings!.streamDrainTrace(_stream, _traceBuffer, _traceCapacity);
+    return List.generate(count, (i) {
+      final r = _traceBuffer[i];
+      return MiniaudioCallbackTrace(
+          r.startNs, r.endNs, r.framesRequested, r.framesDelivered);
+    });
   }
 
-  int get framesConsumed => _bindings?.getFramesConsumed() ?? 0;
-  int get fifoAvailable => _bindings?.getFifoAvailable() ?? 0;
+  /// Drain pending records and return the jitter/load summary.
+  MiniaudioTraceSummary get traceSummary {
+    if (!_initialized) {
+      return const MiniaudioTraceSummary(
+          callbacks: 0,
+          dropped: 0,
+          loadMean: 0,
+          loadMax: 0,
+          intervalErrorMinNs: 0,
+          intervalErrorMaxNs: 0,
+          jitterHistogram: []);
+    }
+    if (_traceSummary == nullptr) {
+      _traceSummary = calloc<MaBridgeTraceSummary>();
+    }
+    _bindings!.streamDrainTrace(_stream, nullptr, 0);
+    _bindings!.streamGetTraceSummary(_stream, _traceSummary);
+    final s = _traceSummary.ref;
+    return MiniaudioTraceSummary(
+      callbacks: s.callbacks,
+      dropped: s.dropped,
+      loadMean: s.loadMean,
+      loadMax: s.loadMax,
+      intervalErrorMinNs: s.intervalErrorMinNs,
+      intervalErrorMaxNs: s.intervalErrorMaxNs,
+      jitterHistogram: List.generate(16, (i) => s.jitterHistogram[i]),
+    );
+  }
+
+  void resetTraceSummary() {
+    if (_initialized) _bindings!.streamResetTraceSummary(_stream);
+  }
+
+  /// Monotonic host clock (ns) used by [timestamp] and the callback trace.
+  int get hostTimeNs => _bindings!.nowNs();
+
+  /// Latest playback clock sample, or null before the first callback.
+  MiniaudioTimestamp? get timestamp {
+    if (!_initialized) return null;
+    if (_timestampPosition == nullptr) {
+      _timestampPosition = calloc<Uint64>();
+      _timestampHostNs = calloc<Uint64>();
+    }
+    if (_bindings!.streamGetTimestamp(
+            _stream, _timestampPosition, _timestampHostNs) !=
+        0) {
+      return null;
+    }
+    return MiniaudioTimestamp(
+      _timestampPosition.value,
+      _timestampHostNs.value,
+      _bindings!.streamGetOutputLatencyFrames(_stream),
+      deviceSampleRate,
+    );
+  }
+  int get fifoAvailable =>
+      _initialized ? _bindings!.streamGetFifoAvailable(_stream) : 0;
   int get fifoAvailableFrames => fifoAvailable ~/ channels;
   double get bufferLatency => fifoAvailableFrames / sampleRate;
+
+  /// Block until the FIFO has room for [frames] frames, woken by the audio
+  /// callback instead of polling with sleep(). Blocks the calling isolate,
+  /// so use it from a dedicated producer isolate, not the UI isolate.
+  /// Returns false on [timeout] or when the player is stopped.
+  bool waitForSpace(int frames,
+      {Duration timeout = const Duration(seconds: 1)}) {
+    if (!_initialized) {
+      return false;
+    }
+    return _bindings!.streamWaitForSpace(
+            _stream, frames, timeout.inMicroseconds * 1000) ==
+        0;
+  }
+
+  /// Block until at most [frames] frames are buffered (a target latency).
+  /// Same threading rules as [waitForSpace].
+  bool waitBelowFill(int frames,
+      {Duration timeout = const Duration(seconds: 1)}) {
+    if (!_initialized) {
+      return false;
+    }
+    return _bindings!.streamWaitBelowFill(
+            _stream, frames, timeout.inMicroseconds * 1000) ==
+        0;
+  }
+
+  /// Events fired when the FIFO fill drops below [watermarkFrames], so a
+  /// producer can react to audio demand instead of polling. Each event is the
+  /// fill in frames at the crossing; it fires once per crossing and re-arms
+  /// when the fill is back at the watermark. Replaces any previous stream.
+  /// The native side posts from a handoff thread, never the audio thread.
+  Stream<int> lowWaterEvents(int watermarkFrames) {
+    stopLowWaterEvents();
+    if (!_initialized) {
+      throw StateError('MiniaudioPlayer not initialized');
+    }
+
+    final port = ReceivePort();
+    if (_bindings!.streamSetLowWaterNotify(_stream,
+            NativeApi.postCObject.cast(), port.sendPort.nativePort,
+            watermarkFrames) !=
+        0) {
+      port.close();
+      throw Exception('Failed to start low-water notification');
+    }
+    _lowWaterPort = port;
+    return port.cast<int>();
+  }
+
+  /// Stop [lowWaterEvents] and close its stream.
+  void stopLowWaterEvents() {
+    if (_lowWaterPort == null) return;
+    if (_stream != nullptr) {
+      _bindings!.streamSetLowWaterNotify(_stream, nullptr, 0, 0);
+    }
+    _lowWaterPort!.close();
+    _lowWaterPort = null;
+  }
+
   bool get isPlaying => _started;
-  set volume(double volume) => _bindings?.setVolume(volume);
-  int get deviceSampleRate => _bindings?.getDeviceSampleRate() ?? 0;
-  int get deviceChannels => _bindings?.getDeviceChannels() ?? 0;
+  set volume(double volume) => setVolume(volume);
+  int get deviceSampleRate =>
+      _initialized ? _bindings!.streamGetDeviceSampleRate(_stream) : 0;
+  int get deviceChannels =>
+      _initialized ? _bindings!.streamGetDeviceChannels(_stream) : 0;
 
   void dispose() {
     if (_isDisposed) return;
     _isDisposed = true;
 
     stop();
-    if (_initialized) {
-      _bindings!.deinit();
+    stopLowWaterEvents();
+    if (_stream != nullptr) {
+      // Only this player's stream; other players and the engine keep running
+      _bindings!.streamDestroy(_stream);
+      _stream = nullptr;
+      _stats = nullptr;
       _initialized = false;
     }
+    // The device is gone, so the capture ring can be freed
+    _input?._detach();
+    _input = null;
     if (_fifoPtr != nullptr) {
       calloc.free(_fifoPtr);
     }
-    if (_readPos != nullptr) calloc.free(_readPos);
-    if (_writePos != nullptr) calloc.free(_writePos);
+    if (_fifoPositions != nullptr) calloc.free(_fifoPositions);
+    calloc.free(_reservePtr1);
+    calloc.free(_reservePtr2);
+    calloc.free(_reserveLen1);
+    calloc.free(_reserveLen2);
+    if (_traceBuffer != nullptr) calloc.free(_traceBuffer);
+    if (_traceSummary != nullptr) calloc.free(_traceSummary);
+    if (_timestampPosition != nullptr) {
+      calloc.free(_timestampPosition);
+      calloc.free(_timestampHostNs);
+    }
+  }
+}
+
+/// Low-latency capture stream (microphone monitoring, voice chat).
+///
+/// The audio callback converts each period into a shared ring allocated
+/// here; Dart reads it in place with [acquire] / [release] or copies it out
+/// with [read]. Nothing goes through platform channels.
+class MiniaudioRecorder {
+  Pointer<MaBridgeStream> _stream = nullptr;
+  Pointer<MaBridgeStreamStats> _stats = nullptr;
+  Pointer<Uint64> _timestampPosition = nullptr;
+  Pointer<Uint64> _timestampHostNs = nullptr;
+  late final Pointer<Uint8> _fifoPtr;
+  late final Pointer<MaBridgeFifoPositions> _fifoPositions;
+
+  // Out-params for ma_bridge_stream_capture_acquire (allocated once)
+  late final Pointer<Pointer<Void>> _acquirePtr1;
+  late final Pointer<Pointer<Void>> _acquirePtr2;
+  late final Pointer<Int32> _acquireLen1;
+  late final Pointer<Int32> _acquireLen2;
+
+  final int sampleRate;
+  final int channels;
+  final int bufferFrames;
+  final int fifoCapacityFrames;
+  final Uint8List? deviceId;
+  final MiniaudioFormat format;
+
+  /// Backend and performance options for this recorder's device.
+  final MiniaudioDeviceConfig? deviceConfig;
+
+  // Duplex player whose device this recorder reads, if any
+  final MiniaudioPlayer? _owner;
+
+  late final int _fifoCapacitySamples = fifoCapacityFrames * channels;
+
+  bool _initialized = false;
+  bool _started = false;
+  bool _isDisposed = false;
+
+  MiniaudioRecorder({
+    required this.sampleRate,
+    this.channels = 2,
+    this.bufferFrames = 512,
+    this.fifoCapacityFrames = 8192,
+    this.deviceId, // Optional specific capture device
+    this.format = MiniaudioFormat.s16,
+    this.deviceConfig,
+  }) : _owner = null {
+    _ensureLibraryLoaded();
+    try {
+      _allocateBuffers();
+      _initDevice();
+    } catch (e) {
+      dispose();
+      rethrow;
+    }
+  }
+
+  // Input side of a duplex player, with the player's settings
+  MiniaudioRecorder._attached(MiniaudioPlayer player)
+      : sampleRate = player.sampleRate,
+        channels = player.channels,
+        bufferFrames = player.bufferFrames,
+        fifoCapacityFrames = player.fifoCapacityFrames,
+        deviceId = player.captureDeviceId,
+        format = player.format,
+        deviceConfig = player.deviceConfig,
+        _owner = player {
+    _allocateBuffers();
+    _attach(player._stream);
+  }
+
+  void _allocateBuffers() {
+    _fifoPtr = calloc<Uint8>(_fifoCapacitySamples * format.bytesPerSample);
+    _fifoPositions = calloc<MaBridgeFifoPositions>();
+    _acquirePtr1 = calloc<Pointer<Void>>();
+    _acquirePtr2 = calloc<Pointer<Void>>();
+    _acquireLen1 = calloc<Int32>();
+    _acquireLen2 = calloc<Int32>();
+  }
+
+  void _initDevice() {
+    final deviceIdPtr = MiniaudioPlayer._copyDeviceId(deviceId);
+    try {
+      MiniaudioDeviceConfig._use(deviceConfig);
+      final stream = _bindings!.streamCreateCapture(
+          deviceIdPtr, sampleRate, channels, bufferFrames, format.value);
+      if (stream == nullptr) {
+        throw Exception('Failed to initialize miniaudio capture device');
+      }
+      _attach(stream);
+    } finally {
+      if (deviceIdPtr != nullptr) {
+        calloc.free(deviceIdPtr);
+      }
+    }
+  }
+
+  void _attach(Pointer<MaBridgeStream> stream) {
+    _stream = stream;
+    _stats = _bindings!.streamGetCaptureStats(_stream);
+    _bindings!.streamSetCaptureFifo(
+        _stream, _fifoPtr.cast(), _fifoCapacitySamples, _fifoPositions);
+    _initialized = true;
+  }
+
+  /// Start capturing. On a duplex player's [MiniaudioPlayer.input] this
+  /// starts the player.
+  void start() {
+    final owner = _owner;
+    if (owner != null) {
+      owner.start();
+      return;
+    }
+    if (!_initialized) {
+      throw StateError('MiniaudioRecorder not initialized');
+    }
+    if (_started) return;
+    if (_bindings!.streamStart(_stream) != 0) {
+      throw Exception('Failed to start audio capture');
+    }
+    _started = true;
+  }
+
+  /// Stop capturing (the whole player for [MiniaudioPlayer.input]).
+  void stop() {
+    final owner = _owner;
+    if (owner != null) {
+      owner.stop();
+      return;
+    }
+    if (!_started) return;
+    _bindings!.streamStop(_stream);
+    _started = false;
+  }
+
+  bool get isRecording => _owner?.isPlaying ?? _started;
+
+  /// Captured frames waiting to be read.
+  int get availableFrames => _initialized
+      ? _bindings!.streamGetCaptureFifoAvailable(_stream) ~/ channels
+      : 0;
+
+  void _checkFormat(MiniaudioFormat expected) {
+    if (format != expected) {
+      throw StateError('MiniaudioRecorder FIFO format is ${format.name}, '
+          'not ${expected.name}');
+    }
+  }
+
+  int _acquireSegments(int frames) => _bindings!.streamCaptureAcquire(
+      _stream, frames, _acquirePtr1, _acquireLen1, _acquirePtr2, _acquireLen2);
+
+  /// Up to [frames] captured frames as views into ring memory (no copy).
+  /// Hand them back with [release] once processed. Requires
+  /// [MiniaudioFormat.s16].
+  MiniaudioFifoReservation<Int16List> acquire(int frames) {
+    _checkFormat(MiniaudioFormat.s16);
+    if (!_initialized) {
+      return MiniaudioFifoReservation._(Int16List(0), Int16List(0), 0);
+    }
+
+    final acquired = _acquireSegments(frames);
+    final len1 = _acquireLen1.value * channels;
+    final len2 = _acquireLen2.value * channels;
+    return MiniaudioFifoReservation._(
+      len1 > 0
+          ? _acquirePtr1.value.cast<Int16>().asTypedList(len1)
+          : Int16List(0),
+      len2 > 0
+          ? _acquirePtr2.value.cast<Int16>().asTypedList(len2)
+          : Int16List(0),
+      acquired,
+    );
+  }
+
+  /// Float counterpart of [acquire]. Requires [MiniaudioFormat.f32].
+  MiniaudioFifoReservation<Float32List> acquireFloat32(int frames) {
+    _checkFormat(MiniaudioFormat.f32);
+    if (!_initialized) {
+      return MiniaudioFifoReservation._(Float32List(0), Float32List(0), 0);
+    }
+
+    final acquired = _acquireSegments(frames);
+    final len1 = _acquireLen1.value * channels;
+    final len2 = _acquireLen2.value * channels;
+    return MiniaudioFifoReservation._(
+      len1 > 0
+          ? _acquirePtr1.value.cast<Float>().asTypedList(len1)
+          : Float32List(0),
+      len2 > 0
+          ? _acquirePtr2.value.cast<Float>().asTypedList(len2)
+          : Float32List(0),
+      acquired,
+    );
+  }
+
+  /// Free [frames] frames from the last [acquire] for the callback to reuse.
+  /// Returns the number of frames released.
+  int release(int frames) {
+    if (!_initialized) {
+      return 0;
+    }
+    return _bindings!.streamCaptureRelease(_stream, frames);
+  }
+
+  /// Copy up to [maxFrames] captured frames into a new list.
+  /// Requires [MiniaudioFormat.s16].
+  Int16List read(int maxFrames) {
+    final acquired = acquire(maxFrames);
+    final out = Int16List(acquired.frames * channels);
+    out.setAll(0, acquired.first);
+    out.setAll(acquired.first.length, acquired.second);
+    release(acquired.frames);
+    return out;
+  }
+
+  /// Float counterpart of [read]. Requires [MiniaudioFormat.f32].
+  Float32List readFloat32(int maxFrames) {
+    final acquired = acquireFloat32(maxFrames);
+    final out = Float32List(acquired.frames * channels);
+    out.setAll(0, acquired.first);
+    out.setAll(acquired.first.length, acquired.second);
+    release(acquired.frames);
+    return out;
+  }
+
+  /// Block until at least [frames] frames are captured, woken by the audio
+  /// callback. Blocks the calling isolate, so use it from a dedicated
+  /// reader isolate. Returns false on [timeout] or when stopped.
+  bool waitForData(int frames,
+      {Duration timeout = const Duration(seconds: 1)}) {
+    if (!_initialized) {
+      return false;
+    }
+    return _bindings!.streamWaitForCapture(
+            _stream, frames, timeout.inMicroseconds * 1000) ==
+        0;
+  }
+
+  /// Capture counters: [MiniaudioStreamStats.framesConsumed] counts frames
+  /// stored, overruns count frames dropped because the reader fell behind.
+  MiniaudioStreamStats get stats {
+    if (!_initialized || _stats == nullptr) {
+      return const MiniaudioStreamStats();
+    }
+    return MiniaudioStreamStats._read(_stats);
+  }
+
+  /// Restart min/max fill tracking. Counters are not cleared.
+  void resetStats() {
+    if (_initialized) _bindings!.streamResetStats(_stream);
+  }
+
+  /// Latest capture clock sample, or null before the first callback.
+  MiniaudioCaptureTimestamp? get timestamp {
+    if (!_initialized) return null;
+    if (_timestampPosition == nullptr) {
+      _timestampPosition = calloc<Uint64>();
+      _timestampHostNs = calloc<Uint64>();
+    }
+    if (_bindings!.streamGetCaptureTimestamp(
+            _stream, _timestampPosition, _timestampHostNs) !=
+        0) {
+      return null;
+    }
+    return MiniaudioCaptureTimestamp(
+      _timestampPosition.value,
+      _timestampHostNs.value,
+      _bindings!.streamGetInputLatencyFrames(_stream),
+      deviceSampleRate,
+    );
+  }
+
+  int get deviceSampleRate =>
+      _initialized ? _bindings!.streamGetDeviceSampleRate(_stream) : 0;
+  int get deviceChannels =>
+      _initialized ? _bindings!.streamGetDeviceChannels(_stream) : 0;
+
+  /// Stop the device and free native resources. Does nothing on a duplex
+  /// player's [MiniaudioPlayer.input], which the player disposes.
+  void dispose() {
+    if (_owner != null || _isDisposed) return;
+    _isDisposed = true;
+
+    stop();
+    if (_stream != nullptr) {
+      _bindings!.streamDestroy(_stream);
+      _stream = nullptr;
+      _stats = nullptr;
+      _initialized = false;
+    }
+    _freeBuffers();
+  }
+
+  // Called by the owning duplex player once its device is destroyed
+  void _detach() {
+    if (_isDisposed) return;
+    _isDisposed = true;
+    _stream = nullptr;
+    _stats = nullptr;
+    _initialized = false;
+    _freeBuffers();
+  }
+
+  void _freeBuffers() {
+    calloc.free(_fifoPtr);
+    calloc.free(_fifoPositions);
+    calloc.free(_acquirePtr1);
+    calloc.free(_acquirePtr2);
+    calloc.free(_acquireLen1);
+    calloc.free(_acquireLen2);
+    if (_timestampPosition != nullptr) {
+      calloc.free(_timestampPosition);
+      calloc.free(_timestampHostNs);
+    }
   }
 }
 
@@ -369,8 +1573,11 @@ abstract class GraphNode {
 class MiniaudioEngine {
   bool _initialized = false;
 
-  MiniaudioEngine() {
+  /// [deviceConfig] sets the backend and performance options of the
+  /// engine's device (the engine always skips pre-silencing and clipping).
+  MiniaudioEngine({MiniaudioDeviceConfig? deviceConfig}) {
     _ensureLibraryLoaded();
+    MiniaudioDeviceConfig._use(deviceConfig);
     if (_bindings!.engineInit() != 0) {
       throw Exception("Failed to init engine");
     }
@@ -1,3 +1,5 @@
 // Relative import to be able to reuse the C sources.
 // See the comment in ../miniaudio_ffi.podspec for more information.
 #include "../../src/miniaudio_bridge.c"
+#include "../../src/miniaudio_bridge_sinc.c"
+#include "../../src/miniaudio_bridge_rt_audit.c"
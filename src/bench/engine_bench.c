@@ -0,0 +1,251 @@
+/*
+ * engine_bench.c - Scaling benchmark for the engine API
+ *
+ * Builds the bridge's engine without a device (like the stream benches, the
+ * bridge is compiled into this executable) and renders it with
+ * ma_engine_read_pcm_frames on the calling thread, so the cost of the mixing
+ * graph is measured alone. Built only with -DMINIAUDIO_FFI_BUILD_BENCH=ON.
+ *
+ *   file       1..512 looping sounds from ma_bridge_sound_init_from_file
+ *   memory     1..512 looping sounds from ma_bridge_sound_init_from_memory
+ *   spatial    1..512 spatialized sounds, moving, with the listener turning
+ *              every period
+ *   chain      16 sounds through 1..64 EQ/filter nodes in series
+ *
+ * Each result is the time spent per rendered second ("ms_per_s"; 1000 means
+ * one core is fully busy in real time), printed as one JSON object per line.
+ * Pass an audio file to measure with it instead of the generated tone. The
+ * bridge's own log goes to stderr.
+ */
+
+#include "../miniaudio_bridge.c"
+
+/* The bridge's log, kept off stdout (see main) */
+static void bench_log(void* user_data, int32_t level, uint64_t time_ns, const char* message) {
+    (void)user_data;
+    (void)level;
+    (void)time_ns;
+    fprintf(stderr, "[miniaudio_bridge] %s\n", message);
+}
+
+#define BENCH_SAMPLE_RATE   48000
+#define BENCH_CHANNELS      2
+#define BENCH_PERIOD_FRAMES 480  /* 10 ms */
+#define BENCH_SECONDS       2    /* Rendered per case */
+#define BENCH_MAX_VOICES    512
+#define BENCH_CHAIN_VOICES  16
+#define BENCH_MAX_CHAIN     64
+#define BENCH_TONE_PATH     "miniaudio_engine_bench.wav"
+
+static const char* g_sound_path = BENCH_TONE_PATH;
+static void* g_sound_data;
+static size_t g_sound_size;
+
+/* One second of a stereo 440 Hz tone as a 16-bit WAV file in memory. */
+static void* bench_make_tone(size_t* pSize) {
+    const ma_uint32 frames = BENCH_SAMPLE_RATE;
+    const ma_uint32 data_bytes = frames * BENCH_CHANNELS * 2;
+    ma_uint8* wav = (ma_uint8*)malloc(44 + data_bytes);
+    if (!wav) return NULL;
+
+    ma_uint32 header[11] = {
+        0x46464952, 36 + data_bytes, 0x45564157,               /* "RIFF" size "WAVE" */
+        0x20746d66, 16, 1 | (BENCH_CHANNELS << 16),            /* "fmt " 16 PCM, channels */
+        BENCH_SAMPLE_RATE, BENCH_SAMPLE_RATE * BENCH_CHANNELS * 2,
+        (BENCH_CHANNELS * 2) | (16 << 16),                     /* Block align, bits */
+        0x61746164, data_bytes                                 /* "data" size */
+    };
+    memcpy(wav, header, sizeof(header)); /* Little-endian targets only, which is all we bench on */
+
+    ma_int16* samples = (ma_int16*)(wav + 44);
+    for (ma_uint32 i = 0; i < frames; i++) {
+        ma_int16 s = (ma_int16)(8000.0 * sin(2.0 * MA_PI_D * 440.0 * i / BENCH_SAMPLE_RATE));
+        for (ma_uint32 c = 0; c < BENCH_CHANNELS; c++) samples[i * BENCH_CHANNELS + c] = s;
+    }
+    *pSize = 44 + data_bytes;
+    return wav;
+}
+
+static void* bench_read_file(const char* path, size_t* pSize) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    void* data = (size > 0) ? malloc((size_t)size) : NULL;
+    if (data && fread(data, 1, (size_t)size, file) != (size_t)size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *pSize = (size_t)size;
+    return data;
+}
+
+/* The bridge's engine, but with no device: the bench pulls it directly. */
+static int bench_engine_init(void) {
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice = MA_TRUE;
+    config.channels = BENCH_CHANNELS;
+    config.sampleRate = BENCH_SAMPLE_RATE;
+    if (ma_engine_init(&config, &g_engine) != MA_SUCCESS) return -1;
+    g_engine_initialized = 1;
+    return 0;
+}
+
+static void bench_engine_uninit(void) {
+    ma_engine_uninit(&g_engine);
+    g_engine_initialized = 0;
+}
+
+static void bench_result(const char* bench, int voices, int nodes, ma_uint64 frames, ma_uint64 elapsed_ns) {
+    double ms_per_s = frames ? (double)elapsed_ns / 1e6 / ((double)frames / BENCH_SAMPLE_RATE) : 0;
+    fprintf(stdout, "{\"bench\":\"%s\",\"voices\":%d,\"nodes\":%d,\"frames\":%llu,\"ms_per_s\":%.3f,\"us_per_voice_s\":%.3f}\n",
+        bench, voices, nodes, (unsigned long long)frames, ms_per_s, voices ? ms_per_s * 1000.0 / voices : 0);
+    fflush(stdout);
+}
+
+/* Spatial case: sounds circle the listener, which turns every period */
+static void bench_move(void** sounds, int voices, ma_uint32 period) {
+    float t = (float)period * BENCH_PERIOD_FRAMES / BENCH_SAMPLE_RATE;
+    ma_bridge_engine_listener_set_direction(0, (float)sin(t), 0, -(float)cos(t));
+    for (int i = 0; i < voices; i++) {
+        float angle = t + (float)i * 0.1f;
+        float radius = 1.0f + (float)(i % 16);
+        ma_bridge_sound_set_position(sounds[i], radius * (float)cos(angle), 0, radius * (float)sin(angle));
+    }
+}
+
+static ma_uint64 bench_render(void** sounds, int voices, ma_bool32 spatial, ma_uint64* pFrames) {
+    float output[BENCH_PERIOD_FRAMES * BENCH_CHANNELS];
+    const ma_uint32 periods = BENCH_SECONDS * BENCH_SAMPLE_RATE / BENCH_PERIOD_FRAMES;
+    ma_uint64 elapsed_ns = 0;
+
+    for (ma_uint32 p = 0; p < periods; p++) {
+        ma_uint64 t0 = ma_bridge_now_ns();
+        if (spatial) bench_move(sounds, voices, p);
+        ma_engine_read_pcm_frames(&g_engine, output, BENCH_PERIOD_FRAMES, NULL);
+        elapsed_ns += ma_bridge_now_ns() - t0;
+    }
+    *pFrames = (ma_uint64)periods * BENCH_PERIOD_FRAMES;
+    return elapsed_ns;
+}
+
+typedef enum { bench_source_file, bench_source_memory } bench_source;
+
+static void* bench_sound_init(bench_source source, int32_t flags) {
+    void* sound = (source == bench_source_file)
+        ? ma_bridge_sound_init_from_file(g_sound_path, flags)
+        : ma_bridge_sound_init_from_memory(g_sound_data, g_sound_size, flags);
+    if (sound) {
+        ma_bridge_sound_set_looping(sound, 1);
+        ma_bridge_sound_play(sound);
+    }
+    return sound;
+}
+
+/* --- Voices --- */
+
+static void bench_voices(const char* name, bench_source source, ma_bool32 spatial) {
+    void* sounds[BENCH_MAX_VOICES] = { 0 };
+    int32_t flags = spatial ? 0 : MA_SOUND_FLAG_NO_SPATIALIZATION;
+    int voices = 0;
+
+    for (int target = 1; target <= BENCH_MAX_VOICES; target *= 2) {
+        if (bench_engine_init() != 0) return;
+        for (voices = 0; voices < target; voices++) {
+            sounds[voices] = bench_sound_init(source, flags);
+            if (!sounds[voices]) break;
+        }
+        ma_uint64 frames = 0;
+        ma_uint64 elapsed_ns = bench_render(sounds, voices, spatial, &frames);
+        bench_result(name, voices, 0, frames, elapsed_ns);
+
+        for (int i = 0; i < voices; i++) ma_bridge_sound_uninit(sounds[i]);
+        bench_engine_uninit();
+        if (voices < target) {
+            fprintf(stderr, "[engine_bench] %s: stopped at %d voices\n", name, voices);
+            return;
+        }
+    }
+}
+
+/* --- Node Chains --- */
+
+static void* bench_node_init(int index) {
+    void* node = NULL;
+    switch (index % 6) {
+        case 0: node = ma_bridge_node_lpf_init(); if (node) ma_bridge_node_lpf_set_cutoff(node, 8000); break;
+        case 1: node = ma_bridge_node_hpf_init(); if (node) ma_bridge_node_hpf_set_cutoff(node, 80); break;
+        case 2: node = ma_bridge_node_peaking_eq_init(); if (node) ma_bridge_node_peaking_eq_set_params(node, 3, 1, 1000); break;
+        case 3: node = ma_bridge_node_low_shelf_init(); if (node) ma_bridge_node_low_shelf_set_params(node, 2, 1, 200); break;
+        case 4: node = ma_bridge_node_high_shelf_init(); if (node) ma_bridge_node_high_shelf_set_params(node, -2, 1, 6000); break;
+        default: node = ma_bridge_node_bpf_init(); if (node) ma_bridge_node_bpf_set_cutoff(node, 2000); break;
+    }
+    return node;
+}
+
+static void bench_chain(void) {
+    void* sounds[BENCH_CHAIN_VOICES] = { 0 };
+    void* nodes[BENCH_MAX_CHAIN] = { 0 };
+
+    for (int length = 1; length <= BENCH_MAX_CHAIN; length *= 2) {
+        if (bench_engine_init() != 0) return;
+        int count = 0;
+        for (; count < length; count++) {
+            nodes[count] = bench_node_init(count);
+            if (!nodes[count]) break;
+        }
+        // sounds -> nodes[0] -> ... -> nodes[count - 1] -> endpoint
+        for (int i = 0; i < count; i++) {
+            void* next = (i + 1 < count) ? nodes[i + 1] : ma_bridge_engine_get_endpoint();
+            ma_bridge_node_attach_output_bus(nodes[i], 0, next, 0);
+        }
+        int voices = 0;
+        for (; voices < BENCH_CHAIN_VOICES; voices++) {
+            sounds[voices] = bench_sound_init(bench_source_file, MA_SOUND_FLAG_NO_SPATIALIZATION);
+            if (!sounds[voices]) break;
+            ma_bridge_sound_route_to_node(sounds[voices], count ? nodes[0] : NULL);
+        }
+
+        ma_uint64 frames = 0;
+        ma_uint64 elapsed_ns = bench_render(sounds, voices, MA_FALSE, &frames);
+        bench_result("chain", voices, count, frames, elapsed_ns);
+
+        for (int i = 0; i < voices; i++) ma_bridge_sound_uninit(sounds[i]);
+        for (int i = 0; i < count; i++) ma_bridge_node_uninit(nodes[i]);
+        bench_engine_uninit();
+        if (count < length) return;
+    }
+}
+
+int main(int argc, char** argv) {
+    ma_bool32 own_file = MA_FALSE;
+    ma_bridge_log_set_stdout(0);
+    ma_bridge_log_set_callback(bench_log, NULL);
+
+    if (argc > 1) {
+        g_sound_path = argv[1];
+        g_sound_data = bench_read_file(g_sound_path, &g_sound_size);
+    } else {
+        g_sound_data = bench_make_tone(&g_sound_size);
+        FILE* file = g_sound_data ? fopen(BENCH_TONE_PATH, "wb") : NULL;
+        if (file) {
+            own_file = fwrite(g_sound_data, 1, g_sound_size, file) == g_sound_size;
+            fclose(file);
+        }
+    }
+    if (!g_sound_data) {
+        fprintf(stderr, "[engine_bench] Could not load %s\n", g_sound_path);
+        return 1;
+    }
+
+    bench_voices("file", bench_source_file, MA_FALSE);
+    bench_voices("memory", bench_source_memory, MA_FALSE);
+    bench_voices("spatial", bench_source_file, MA_TRUE);
+    bench_chain();
+
+    if (own_file) remove(BENCH_TONE_PATH);
+    free(g_sound_data);
+    return 0;
+}
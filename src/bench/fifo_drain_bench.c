@@ -0,0 +1,139 @@
+/*
+ * fifo_drain_bench.c - Microbenchmark for the device FIFO drain path
+ *
+ * Compares the original per-sample modulo drain against the stream's
+ * two-segment copy, for a power-of-two (masked) ring and a non power-of-two
+ * (modulo fallback) ring, plus the converting drain used when the device
+ * runs in f32. Built only with -DMINIAUDIO_FFI_BUILD_BENCH=ON.
+ *
+ * The bridge is compiled into this executable (like the Apple forwarders do)
+ * so the static stream render path can be driven directly without a device.
+ */
+
+#include "../miniaudio_bridge.c"
+
+#if _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define BENCH_CHANNELS      2
+#define BENCH_PERIOD_FRAMES 64
+#define BENCH_ROUNDS        20000
+
+static uint64_t bench_now_ns(void) {
+#if _WIN32
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* The drain loop as it was before the two-segment rewrite, on its own state. */
+static int16_t* legacy_fifo;
+static int legacy_capacity;
+static volatile int legacy_read_pos;
+static volatile int legacy_write_pos;
+
+static void legacy_fill(ma_uint32 frames) {
+    legacy_write_pos = (legacy_write_pos + (int)frames * BENCH_CHANNELS) % legacy_capacity;
+}
+
+static void legacy_drain(void* pOutput, ma_uint32 frameCount) {
+    int16_t* output = (int16_t*)pOutput;
+    int samples_needed = frameCount * BENCH_CHANNELS;
+    int read = legacy_read_pos;
+    int write = legacy_write_pos;
+    int available = (write >= read) ? (write - read) : (legacy_capacity - read + write);
+    int samples_to_read = (available < samples_needed) ? available : samples_needed;
+
+    for (int i = 0; i < samples_to_read; i++) {
+        output[i] = legacy_fifo[(read + i) % legacy_capacity];
+    }
+    if (samples_to_read < samples_needed) {
+        memset(output + samples_to_read, 0, (samples_needed - samples_to_read) * sizeof(int16_t));
+    }
+    legacy_read_pos = (read + samples_to_read) % legacy_capacity;
+}
+
+/* The bridge path: ma_bridge_stream_write_device_fifo in, ma_bridge_stream_process out. */
+static ma_bridge_stream bench_stream;
+static int16_t* bridge_chunk;
+
+static void bridge_fill(ma_uint32 frames) {
+    ma_bridge_stream_write_device_fifo(&bench_stream, bridge_chunk, (int32_t)frames);
+}
+
+static void bridge_drain(void* output, ma_uint32 frameCount) {
+    ma_bridge_stream_process(&bench_stream, NULL, output, frameCount);
+}
+
+typedef struct {
+    void (*fill)(ma_uint32 frames);
+    void (*drain)(void* output, ma_uint32 frameCount);
+    ma_format device_format; /* Output format of the drain (bridge only) */
+} drain_case;
+
+static double run_case(const drain_case* pCase, int capacity_samples) {
+    int16_t* fifo = (int16_t*)calloc(capacity_samples, sizeof(int16_t));
+    float output[BENCH_PERIOD_FRAMES * BENCH_CHANNELS]; /* Large enough for any output format */
+    ma_bridge_fifo_positions positions;
+    uint64_t elapsed = 0;
+    uint64_t frames = 0;
+
+    bridge_chunk = (int16_t*)calloc(capacity_samples, sizeof(int16_t));
+    for (int i = 0; i < capacity_samples; i++) bridge_chunk[i] = (int16_t)i;
+
+    bench_stream.channels = BENCH_CHANNELS;
+    bench_stream.format = ma_format_s16;
+    bench_stream.device_format = pCase->device_format;
+    ma_bridge_stream_set_fifo(&bench_stream, fifo, capacity_samples, &positions);
+    legacy_fifo = fifo;
+    legacy_capacity = capacity_samples;
+    legacy_read_pos = 0;
+    legacy_write_pos = 0;
+
+    int periods_per_fill = (capacity_samples / BENCH_CHANNELS - 1) / BENCH_PERIOD_FRAMES;
+    for (int round = 0; round < BENCH_ROUNDS / periods_per_fill + 1; round++) {
+        pCase->fill(periods_per_fill * BENCH_PERIOD_FRAMES);
+
+        uint64_t t0 = bench_now_ns();
+        for (int p = 0; p < periods_per_fill; p++) {
+            pCase->drain(output, BENCH_PERIOD_FRAMES);
+        }
+        elapsed += bench_now_ns() - t0;
+        frames += (uint64_t)periods_per_fill * BENCH_PERIOD_FRAMES;
+    }
+
+    ma_bridge_stream_set_fifo(&bench_stream, NULL, 0, NULL);
+    free(bridge_chunk);
+    free(fifo);
+    return (double)elapsed / (double)frames;
+}
+
+int main(void) {
+    // The table goes to stdout; keep the bridge's FIFO messages out of it
+    ma_bridge_log_set_stdout(0);
+
+    const int pow2_capacity = 16384;
+    const int odd_capacity = 12000 * BENCH_CHANNELS;
+
+    const drain_case legacy = { legacy_fill, legacy_drain, ma_format_s16 };
+    const drain_case bridge = { bridge_fill, bridge_drain, ma_format_s16 };
+    const drain_case bridge_f32 = { bridge_fill, bridge_drain, ma_format_f32 };
+
+    printf("fifo drain, %d ch, %d-frame periods\n", BENCH_CHANNELS, BENCH_PERIOD_FRAMES);
+    printf("%-28s %10s\n", "case", "ns/frame");
+    printf("%-28s %10.3f\n", "legacy modulo (pow2 cap)", run_case(&legacy, pow2_capacity));
+    printf("%-28s %10.3f\n", "two-segment (pow2 cap)", run_case(&bridge, pow2_capacity));
+    printf("%-28s %10.3f\n", "legacy modulo (odd cap)", run_case(&legacy, odd_capacity));
+    printf("%-28s %10.3f\n", "two-segment (odd cap)", run_case(&bridge, odd_capacity));
+    printf("%-28s %10.3f\n", "s16 -> f32 device (pow2 cap)", run_case(&bridge_f32, pow2_capacity));
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * rt_audit_check.c - Drives the audio-thread paths under the RT audit
+ *
+ * Built only with -DMINIAUDIO_FFI_RT_AUDIT=ON, against the same wrapped
+ * bridge as the audited library. Runs offline streams (FIFO drain, format
+ * conversion, push and pull resampling, rate control, trace, underruns,
+ * render callback, low-water notifications, the pump thread) and a
+ * device-less engine (sounds, spatialization, EQ/filter/delay/splitter
+ * nodes), then prints the audit report. Exits non-zero if anything on the
+ * audio thread allocated, locked or printed, so a low-period configuration
+ * can be gated on it. MA_BRIDGE_RT_AUDIT=abort stops at the first call
+ * (useful under a debugger).
+ */
+
+#include "../miniaudio_bridge.c"
+
+#define CHECK_SAMPLE_RATE   48000
+#define CHECK_CHANNELS      2
+#define CHECK_PERIOD_FRAMES 64  /* A low-period configuration */
+#define CHECK_FIFO_FRAMES   4096
+#define CHECK_PERIODS       2000
+
+static ma_int16 g_source[CHECK_FIFO_FRAMES * CHECK_CHANNELS];
+
+static int32_t check_render(void* user_data, void* output, int32_t frame_count) {
+    (void)user_data;
+    memset(output, 0, (size_t)(frame_count / 2) * CHECK_CHANNELS * sizeof(float));
+    return frame_count / 2; /* The FIFO supplies the rest */
+}
+
+static int8_t check_post(int64_t port, ma_bridge_dart_cobject* message) {
+    (void)port;
+    (void)message;
+    return 1;
+}
+
+/* One offline stream through `periods` periods, with the producer on this thread between them. */
+static void check_stream(const char* name, ma_bridge_format format, ma_bridge_format device_format, int source_rate, ma_bool32 pull, int quality) {
+    static ma_uint8 fifo[CHECK_FIFO_FRAMES * CHECK_CHANNELS * 4];
+    ma_bridge_fifo_positions positions;
+    memset(&positions, 0, sizeof(positions));
+
+    ma_bridge_stream* pStream = ma_bridge_stream_create_offline(CHECK_SAMPLE_RATE, CHECK_CHANNELS, CHECK_PERIOD_FRAMES, format, device_format);
+    if (!pStream) return;
+    ma_bridge_stream_set_fifo(pStream, fifo, CHECK_FIFO_FRAMES * CHECK_CHANNELS, &positions);
+    ma_bridge_stream_set_trace_enabled(pStream, 1);
+    ma_bridge_stream_set_low_water_notify(pStream, (void*)check_post, 1, CHECK_FIFO_FRAMES / 4);
+    ma_bridge_stream_set_resample_quality(pStream, quality);
+    if (source_rate != CHECK_SAMPLE_RATE) {
+        if (pull) {
+            ma_bridge_stream_init_pull_resampler(pStream, source_rate);
+        } else {
+            ma_bridge_stream_init_resampler(pStream, source_rate, CHECK_SAMPLE_RATE);
+        }
+    }
+    ma_bridge_stream_set_rate_control(pStream, CHECK_FIFO_FRAMES / 2, 0.005f);
+    if (device_format == ma_bridge_format_f32 && format == ma_bridge_format_f32) {
+        pStream->render_proc = check_render;
+    }
+
+    // Alternate full and starved stretches so the underrun paths run too
+    int32_t chunk = source_rate / 100 / 4;
+    for (int p = 0; p < CHECK_PERIODS; p++) {
+        if ((p / 200) % 2 == 0) ma_bridge_stream_write_pcm_frames(pStream, g_source, chunk);
+        ma_bridge_stream_pump(pStream, 1, NULL);
+    }
+
+    // And the pump thread, with the producer racing it
+    ma_bridge_stream_set_offline_clock(pStream, 8, 200, 7);
+    ma_bridge_stream_start(pStream);
+    for (int i = 0; i < 50; i++) {
+        if (ma_bridge_stream_wait_for_space(pStream, chunk, 10000000) == 0) ma_bridge_stream_write_pcm_frames(pStream, g_source, chunk);
+    }
+    ma_bridge_stream_stop(pStream);
+    ma_bridge_stream_destroy(pStream);
+    fprintf(stderr, "[rt_audit_check] stream: %s\n", name);
+}
+
+static void check_engine(void) {
+    ma_engine_config config = ma_engine_config_init();
+    config.noDevice = MA_TRUE;
+    config.channels = CHECK_CHANNELS;
+    config.sampleRate = CHECK_SAMPLE_RATE;
+    if (ma_engine_init(&config, &g_engine) != MA_SUCCESS) return;
+    g_engine_initialized = 1;
+
+    void* nodes[] = {
+        ma_bridge_node_lpf_init(), ma_bridge_node_hpf_init(), ma_bridge_node_peaking_eq_init(),
+        ma_bridge_node_low_shelf_init(), ma_bridge_node_high_shelf_init(), ma_bridge_node_bpf_init(),
+        ma_bridge_node_delay_init(), ma_bridge_node_splitter_init()
+    };
+    const int node_count = (int)(sizeof(nodes) / sizeof(nodes[0]));
+    for (int i = 0; i < node_count; i++) {
+        if (nodes[i]) ma_bridge_node_attach_output_bus(nodes[i], 0, (i + 1 < node_count && nodes[i + 1]) ? nodes[i + 1] : ma_bridge_engine_get_endpoint(), 0);
+    }
+
+    void* sounds[8];
+    for (int i = 0; i < 8; i++) {
+        sounds[i] = (i % 2) ? ma_bridge_sound_init_waveform(ma_waveform_type_sine, 0.1f, 220.0 * (i + 1))
+                            : ma_bridge_sound_init_noise(ma_noise_type_pink, 0.05f, i);
+        if (!sounds[i]) continue;
+        if (i < 4) ma_bridge_sound_route_to_node(sounds[i], nodes[0]);
+        ma_bridge_sound_set_position(sounds[i], (float)i, 0, -1);
+        ma_bridge_sound_set_pitch(sounds[i], 1.0f + 0.01f * i);
+        ma_bridge_sound_play(sounds[i]);
+    }
+
+    float output[CHECK_PERIOD_FRAMES * CHECK_CHANNELS];
+    for (int p = 0; p < CHECK_PERIODS; p++) {
+        ma_bridge_engine_listener_set_direction(0, (float)sin(p * 0.01), 0, -(float)cos(p * 0.01));
+        MA_BRIDGE_RT_ENTER("engine_callback");
+        ma_engine_read_pcm_frames(&g_engine, output, CHECK_PERIOD_FRAMES, NULL);
+        MA_BRIDGE_RT_LEAVE();
+    }
+
+    for (int i = 0; i < 8; i++) ma_bridge_sound_uninit(sounds[i]);
+    for (int i = 0; i < node_count; i++) ma_bridge_node_uninit(nodes[i]);
+    ma_engine_uninit(&g_engine);
+    g_engine_initialized = 0;
+    fprintf(stderr, "[rt_audit_check] engine\n");
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(g_source) / sizeof(g_source[0]); i++) g_source[i] = (ma_int16)(i * 31);
+
+    check_stream("s16 -> s16", ma_bridge_format_s16, ma_bridge_format_s16, CHECK_SAMPLE_RATE, MA_FALSE, 0);
+    check_stream("s16 -> f32", ma_bridge_format_s16, ma_bridge_format_f32, CHECK_SAMPLE_RATE, MA_FALSE, 0);
+    check_stream("s16 push linear 44100", ma_bridge_format_s16, ma_bridge_format_s16, 44100, MA_FALSE, 0);
+    check_stream("s16 push sinc 44100", ma_bridge_format_s16, ma_bridge_format_f32, 44100, MA_FALSE, 2);
+    check_stream("s16 pull linear 44100", ma_bridge_format_s16, ma_bridge_format_s16, 44100, MA_TRUE, 0);
+    check_stream("s16 pull sinc 44100", ma_bridge_format_s16, ma_bridge_format_f32, 44100, MA_TRUE, 3);
+    check_stream("f32 render callback", ma_bridge_format_f32, ma_bridge_format_f32, CHECK_SAMPLE_RATE, MA_FALSE, 0);
+    check_engine();
+
+    ma_bridge_rt_audit_report report;
+    if (ma_bridge_rt_audit_get_report(&report) != 0) {
+        fprintf(stderr, "[rt_audit_check] The audit is not compiled in\n");
+        return 2;
+    }
+    uint64_t total = report.allocations + report.locks + report.prints;
+    fprintf(stdout, "allocations=%llu locks=%llu prints=%llu", (unsigned long long)report.allocations, (unsigned long long)report.locks, (unsigned long long)report.prints);
+    if (total) fprintf(stdout, " last=%s in %s", report.last_call, report.last_site);
+    fprintf(stdout, "\n");
+    return total ? 1 : 0;
+}
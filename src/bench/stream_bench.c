@@ -0,0 +1,244 @@
+/*
+ * stream_bench.c - Microbenchmarks for the stream hot paths
+ *
+ * Runs with the device stubbed out: an offline stream (virtual clock, no
+ * audio hardware) stands in for the device, so the numbers cover the bridge
+ * alone and are repeatable on CI machines. Built only with
+ * -DMINIAUDIO_FFI_BUILD_BENCH=ON.
+ *
+ *   callback   one audio callback period (FIFO drain, format conversion,
+ *              pull resampling), per output frame
+ *   write      ma_bridge_stream_write_device_fifo at several chunk sizes,
+ *              per frame written
+ *   resample   ma_bridge_stream_write_pcm_frames through the push
+ *              resampler, per input frame
+ *   contention a producer writing while the pump thread drains in real
+ *              time, per frame written (time spent in the write calls);
+ *              underruns count periods the producer could not keep fed
+ *
+ * Results go to stdout as one JSON object per line; the bridge's own log is
+ * sent to stderr. An optional argument scales the amount
+ * of work (default 1).
+ */
+
+#include "../miniaudio_bridge.c"
+
+/* The bridge's log, kept off stdout (see main) */
+static void bench_log(void* user_data, int32_t level, uint64_t time_ns, const char* message) {
+    (void)user_data;
+    (void)level;
+    (void)time_ns;
+    fprintf(stderr, "[miniaudio_bridge] %s\n", message);
+}
+
+#define BENCH_SAMPLE_RATE   48000
+#define BENCH_CHANNELS      2
+#define BENCH_PERIOD_FRAMES 256
+#define BENCH_FIFO_FRAMES   16384
+#define BENCH_FRAMES        (1u << 22) /* Per case, times the scale argument */
+#define BENCH_REALTIME_FRAMES (BENCH_SAMPLE_RATE * 2) /* Contention cases run at 1x, so this is 2 s each */
+
+static ma_uint64 g_bench_frames = BENCH_FRAMES;
+static ma_uint64 g_realtime_frames = BENCH_REALTIME_FRAMES;
+
+typedef struct {
+    ma_bridge_stream* stream;
+    ma_bridge_fifo_positions positions;
+    void* fifo;
+    void* chunk;  /* Source audio, a full FIFO's worth */
+} bench_stream;
+
+static void bench_result(const char* bench, const char* name, ma_uint64 frames, ma_uint64 elapsed_ns, ma_uint64 underrun_frames) {
+    double ns_per_frame = frames ? (double)elapsed_ns / (double)frames : 0;
+    fprintf(stdout, "{\"bench\":\"%s\",\"case\":\"%s\",\"frames\":%llu,\"ns_per_frame\":%.4f,\"mframes_per_s\":%.3f,\"underrun_frames\":%llu}\n",
+        bench, name, (unsigned long long)frames, ns_per_frame, ns_per_frame > 0 ? 1000.0 / ns_per_frame : 0, (unsigned long long)underrun_frames);
+    fflush(stdout);
+}
+
+static int bench_open(bench_stream* pBench, ma_bridge_format format, ma_bridge_format device_format) {
+    ma_uint32 bytes = BENCH_FIFO_FRAMES * BENCH_CHANNELS * ma_get_bytes_per_sample((ma_format)format);
+
+    memset(pBench, 0, sizeof(*pBench));
+    pBench->stream = ma_bridge_stream_create_offline(BENCH_SAMPLE_RATE, BENCH_CHANNELS, BENCH_PERIOD_FRAMES, format, device_format);
+    pBench->fifo = calloc(1, bytes);
+    pBench->chunk = malloc(bytes);
+    if (!pBench->stream || !pBench->fifo || !pBench->chunk) return -1;
+
+    // A quiet ramp, so conversions and the resampler see non-trivial input
+    if (format == ma_bridge_format_f32) {
+        for (ma_uint32 i = 0; i < BENCH_FIFO_FRAMES * BENCH_CHANNELS; i++) ((float*)pBench->chunk)[i] = (float)(i % 4096) / 16384.0f;
+    } else {
+        for (ma_uint32 i = 0; i < bytes; i++) ((ma_uint8*)pBench->chunk)[i] = (ma_uint8)(i * 7);
+    }
+    ma_bridge_stream_set_fifo(pBench->stream, pBench->fifo, BENCH_FIFO_FRAMES * BENCH_CHANNELS, &pBench->positions);
+    return 0;
+}
+
+static void bench_close(bench_stream* pBench) {
+    if (pBench->stream) ma_bridge_stream_destroy(pBench->stream);
+    free(pBench->fifo);
+    free(pBench->chunk);
+}
+
+static void bench_refill(bench_stream* pBench) {
+    while (ma_bridge_stream_write_device_fifo(pBench->stream, pBench->chunk, BENCH_FIFO_FRAMES) > 0) {
+    }
+}
+
+static ma_uint64 bench_underruns(bench_stream* pBench) {
+    return ma_bridge_stream_get_stats(pBench->stream)->underrun_frames;
+}
+
+/* --- Callback --- */
+
+static void bench_callback(const char* name, ma_bridge_format format, ma_bridge_format device_format, int source_rate, int quality) {
+    bench_stream bench;
+    if (bench_open(&bench, format, device_format) != 0) {
+        bench_close(&bench);
+        return;
+    }
+    if (source_rate != BENCH_SAMPLE_RATE) {
+        ma_bridge_stream_set_resample_quality(bench.stream, quality);
+        ma_bridge_stream_init_pull_resampler(bench.stream, source_rate);
+    }
+
+    // Drain at most half the FIFO between refills, so no period underruns
+    const int32_t periods = BENCH_FIFO_FRAMES / 2 / BENCH_PERIOD_FRAMES;
+    ma_uint64 frames = 0;
+    ma_uint64 elapsed_ns = 0;
+    while (frames < g_bench_frames) {
+        bench_refill(&bench);
+        ma_uint64 t0 = ma_bridge_now_ns();
+        ma_bridge_stream_pump(bench.stream, periods, NULL);
+        elapsed_ns += ma_bridge_now_ns() - t0;
+        frames += (ma_uint64)periods * BENCH_PERIOD_FRAMES;
+    }
+    bench_result("callback", name, frames, elapsed_ns, bench_underruns(&bench));
+    bench_close(&bench);
+}
+
+/* --- FIFO Writes --- */
+
+static void bench_write(int32_t chunk_frames) {
+    char name[32];
+    bench_stream bench;
+    snprintf(name, sizeof(name), "s16 chunk %d", (int)chunk_frames);
+    if (bench_open(&bench, ma_bridge_format_s16, ma_bridge_format_s16) != 0) {
+        bench_close(&bench);
+        return;
+    }
+
+    const int32_t periods = BENCH_FIFO_FRAMES / BENCH_PERIOD_FRAMES;
+    ma_uint64 frames = 0;
+    ma_uint64 elapsed_ns = 0;
+    while (frames < g_bench_frames) {
+        ma_uint64 t0 = ma_bridge_now_ns();
+        for (int32_t written = 0; written + chunk_frames <= BENCH_FIFO_FRAMES; written += chunk_frames) {
+            ma_bridge_stream_write_device_fifo(bench.stream, bench.chunk, chunk_frames);
+        }
+        elapsed_ns += ma_bridge_now_ns() - t0;
+        frames += (BENCH_FIFO_FRAMES / chunk_frames) * (ma_uint64)chunk_frames;
+        ma_bridge_stream_pump(bench.stream, periods, NULL);
+    }
+    bench_result("write", name, frames, elapsed_ns, 0);
+    bench_close(&bench);
+}
+
+/* --- Push Resampling --- */
+
+static void bench_resample(const char* name, ma_bridge_format format, int quality) {
+    const int source_rate = 44100;
+    const int32_t chunk_frames = 441; /* 10 ms */
+    bench_stream bench;
+    if (bench_open(&bench, format, format) != 0) {
+        bench_close(&bench);
+        return;
+    }
+    ma_bridge_stream_set_resample_quality(bench.stream, quality);
+    if (ma_bridge_stream_init_resampler(bench.stream, source_rate, BENCH_SAMPLE_RATE) != 0) {
+        bench_close(&bench);
+        return;
+    }
+
+    // Each round fills about half the FIFO (at the output rate), then drains it
+    const int32_t chunks = (int32_t)((ma_uint64)BENCH_FIFO_FRAMES / 2 * source_rate / BENCH_SAMPLE_RATE / chunk_frames);
+    const int32_t periods = BENCH_FIFO_FRAMES / BENCH_PERIOD_FRAMES;
+    ma_uint64 frames = 0;
+    ma_uint64 elapsed_ns = 0;
+    while (frames < g_bench_frames) {
+        ma_uint64 t0 = ma_bridge_now_ns();
+        for (int32_t i = 0; i < chunks; i++) {
+            ma_bridge_stream_write_pcm_frames(bench.stream, bench.chunk, chunk_frames);
+        }
+        elapsed_ns += ma_bridge_now_ns() - t0;
+        frames += (ma_uint64)chunks * chunk_frames;
+        ma_bridge_stream_pump(bench.stream, periods, NULL);
+    }
+    bench_result("resample", name, frames, elapsed_ns, 0);
+    bench_close(&bench);
+}
+
+/* --- Producer / Consumer Contention --- */
+
+static void bench_contention(int32_t chunk_frames) {
+    char name[32];
+    bench_stream bench;
+    snprintf(name, sizeof(name), "s16 chunk %d", (int)chunk_frames);
+    if (bench_open(&bench, ma_bridge_format_s16, ma_bridge_format_s16) != 0) {
+        bench_close(&bench);
+        return;
+    }
+
+    // The pump thread drains at the device rate, like a real callback, so
+    // underruns only appear when the producer falls behind real time
+    ma_bridge_stream_set_offline_clock(bench.stream, 1, 0, 1);
+    bench_refill(&bench);
+    if (ma_bridge_stream_start(bench.stream) != 0) {
+        bench_close(&bench);
+        return;
+    }
+    ma_uint64 frames = 0;
+    ma_uint64 elapsed_ns = 0;
+    while (frames < g_realtime_frames) {
+        if (ma_bridge_stream_wait_for_space(bench.stream, chunk_frames, 1000000) != 0) continue;
+        ma_uint64 t0 = ma_bridge_now_ns();
+        frames += (ma_uint64)ma_bridge_stream_write_device_fifo(bench.stream, bench.chunk, chunk_frames);
+        elapsed_ns += ma_bridge_now_ns() - t0;
+    }
+    ma_bridge_stream_stop(bench.stream);
+    bench_result("contention", name, frames, elapsed_ns, bench_underruns(&bench));
+    bench_close(&bench);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        double scale = atof(argv[1]);
+        if (scale > 0) {
+            g_bench_frames = (ma_uint64)(BENCH_FRAMES * scale);
+            g_realtime_frames = (ma_uint64)(BENCH_REALTIME_FRAMES * scale);
+        }
+    }
+    ma_bridge_log_set_stdout(0);
+    ma_bridge_log_set_callback(bench_log, NULL);
+
+    bench_callback("s16 -> s16", ma_bridge_format_s16, ma_bridge_format_s16, BENCH_SAMPLE_RATE, 0);
+    bench_callback("s16 -> f32", ma_bridge_format_s16, ma_bridge_format_f32, BENCH_SAMPLE_RATE, 0);
+    bench_callback("f32 -> f32", ma_bridge_format_f32, ma_bridge_format_f32, BENCH_SAMPLE_RATE, 0);
+    bench_callback("s16 pull linear 44100", ma_bridge_format_s16, ma_bridge_format_s16, 44100, 0);
+    bench_callback("s16 pull sinc16 44100", ma_bridge_format_s16, ma_bridge_format_s16, 44100, 2);
+
+    const int32_t chunk_sizes[] = { 16, 64, 256, 1024, 4096 };
+    for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+        bench_write(chunk_sizes[i]);
+    }
+
+    bench_resample("s16 linear 44100", ma_bridge_format_s16, 0);
+    bench_resample("s16 sinc8 44100", ma_bridge_format_s16, 1);
+    bench_resample("s16 sinc16 44100", ma_bridge_format_s16, 2);
+    bench_resample("s16 sinc32 44100", ma_bridge_format_s16, 3);
+    bench_resample("f32 linear 44100", ma_bridge_format_f32, 0);
+
+    bench_contention(64);
+    bench_contention(1024);
+    return 0;
+}
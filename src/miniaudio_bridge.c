@@ -11,10 +11,26 @@
 #define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio.h"
 #include "miniaudio_bridge.h"
+#include "miniaudio_bridge_sinc.h"
+#include "miniaudio_bridge_rt_audit.h"
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#ifndef _WIN32
+#include <time.h>
+#endif
+#if defined(__linux__)
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/semaphore.h>
+#elif !defined(_WIN32)
+#include <semaphore.h>
+#endif
 
 // MA_BRIDGE_EXPORT is defined in header
 
@@ -25,478 +41,2674 @@
 static ma_context g_context;
 static int g_context_initialized = 0;
 
-/* Device (Low-Level Stream) */
-static ma_device g_device;
-static int g_device_initialized = 0;
-static int g_device_started = 0;
-
 /* Engine (High-Level Mixer) */
 static ma_engine g_engine;
+static ma_device g_engine_device; /* Opened by the bridge so the device options apply */
 static int g_engine_initialized = 0;
 
-/* Logging Control */
-static int g_log_enabled = 0; // Default to false (Silent)
+/* --- Sample Conversion --- */
+
+/*
+ * Format conversion between the FIFO and the device, applied while draining
+ * the ring so no intermediate buffer is needed. s16 <-> f32 (the common
+ * case) has SSE2/NEON kernels using miniaudio's scaling; the remaining pairs
+ * go through ma_pcm_convert.
+ */
+static void ma_bridge_pcm_s16_to_f32(float* dst, const ma_int16* src, ma_uint32 count) {
+    ma_uint32 i = 0;
+#if defined(MA_SUPPORT_SSE2)
+    if (ma_has_sse2()) {
+        const __m128 scale = _mm_set1_ps(0.000030517578125f);
+        for (; i + 8 <= count; i += 8) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+            _mm_storeu_ps(dst + i,     _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+    }
+#elif defined(MA_SUPPORT_NEON)
+    if (ma_has_neon()) {
+        const float32x4_t scale = vdupq_n_f32(0.000030517578125f);
+        for (; i + 8 <= count; i += 8) {
+            int16x8_t x = vld1q_s16(src + i);
+            vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))),  scale));
+            vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), scale));
+        }
+    }
+#endif
+    for (; i < count; i += 1) {
+        dst[i] = (float)src[i] * 0.000030517578125f;
+    }
+}
+
+static void ma_bridge_pcm_f32_to_s16(ma_int16* dst, const float* src, ma_uint32 count) {
+    ma_uint32 i = 0;
+#if defined(MA_SUPPORT_SSE2)
+    if (ma_has_sse2()) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 minus_one = _mm_set1_ps(-1.0f);
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        for (; i + 8 <= count; i += 8) {
+            __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i),     minus_one), one);
+            __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minus_one), one);
+            __m128i ia = _mm_cvttps_epi32(_mm_mul_ps(a, scale));
+            __m128i ib = _mm_cvttps_epi32(_mm_mul_ps(b, scale));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(ia, ib));
+        }
+    }
+#elif defined(MA_SUPPORT_NEON)
+    if (ma_has_neon()) {
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t minus_one = vdupq_n_f32(-1.0f);
+        const float32x4_t scale = vdupq_n_f32(32767.0f);
+        for (; i + 8 <= count; i += 8) {
+            float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(src + i),     minus_one), one);
+            float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), minus_one), one);
+            int32x4_t ia = vcvtq_s32_f32(vmulq_f32(a, scale));
+            int32x4_t ib = vcvtq_s32_f32(vmulq_f32(b, scale));
+            vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)));
+        }
+    }
+#endif
+    for (; i < count; i += 1) {
+        float x = src[i];
+        x = ((x < -1) ? -1 : ((x > 1) ? 1 : x));
+        dst[i] = (ma_int16)(x * 32767.0f);
+    }
+}
+
+static void ma_bridge_pcm_convert(void* dst, ma_format dstFormat, const void* src, ma_format srcFormat, ma_uint32 count) {
+    if (dstFormat == srcFormat) {
+        memcpy(dst, src, count * ma_get_bytes_per_sample(srcFormat));
+    } else if (srcFormat == ma_format_s16 && dstFormat == ma_format_f32) {
+        ma_bridge_pcm_s16_to_f32((float*)dst, (const ma_int16*)src, count);
+    } else if (srcFormat == ma_format_f32 && dstFormat == ma_format_s16) {
+        ma_bridge_pcm_f32_to_s16((ma_int16*)dst, (const float*)src, count);
+    } else {
+        ma_pcm_convert(dst, dstFormat, src, srcFormat, count, ma_dither_mode_none);
+    }
+}
+
+
+/* --- SPSC Ring --- */
+
+/*
+ * Single-producer/single-consumer ring over caller-owned memory.
+ * Positions are monotonically increasing 64-bit sample counters kept in a
+ * shared ma_bridge_fifo_positions block; each side only ever stores its own
+ * counter (release) and loads the other one (acquire), so no locks or full
+ * barriers are needed and nothing is lost to a "one empty slot" gap.
+ * Samples are opaque here; `format` only sets their size.
+ */
+typedef struct {
+    ma_uint8* buffer;
+    ma_uint32 capacity;  /* in samples */
+    ma_uint32 mask;      /* capacity - 1 for power-of-two rings, else 0 (modulo fallback) */
+    ma_format format;
+    ma_uint32 bytes_per_sample;
+    ma_bridge_fifo_positions* pos;
+} ma_bridge_ring;
+
+static void ma_bridge_ring_init(ma_bridge_ring* pRing, void* buffer, ma_uint32 capacity, ma_format format, ma_bridge_fifo_positions* pos) {
+    pRing->buffer = (ma_uint8*)buffer;
+    pRing->capacity = capacity;
+    pRing->mask = (capacity > 0 && (capacity & (capacity - 1)) == 0) ? capacity - 1 : 0;
+    pRing->format = format;
+    pRing->bytes_per_sample = ma_get_bytes_per_sample(format);
+    pRing->pos = pos;
+    if (pos) {
+        ma_atomic_store_explicit_64(&pos->write_pos, 0, ma_atomic_memory_order_relaxed);
+        ma_atomic_store_explicit_64(&pos->read_pos, 0, ma_atomic_memory_order_release);
+    }
+}
+
+static MA_INLINE ma_bool32 ma_bridge_ring_is_valid(const ma_bridge_ring* pRing) {
+    return pRing->buffer != NULL && pRing->pos != NULL && pRing->capacity > 0;
+}
+
+static MA_INLINE ma_uint32 ma_bridge_ring_index(const ma_bridge_ring* pRing, ma_uint64 counter) {
+    return pRing->mask ? (ma_uint32)(counter & pRing->mask) : (ma_uint32)(counter % pRing->capacity);
+}
+
+/* Samples currently stored. Safe to call from any thread. */
+static ma_uint32 ma_bridge_ring_fill(const ma_bridge_ring* pRing) {
+    ma_uint64 read = ma_atomic_load_explicit_64(&pRing->pos->read_pos, ma_atomic_memory_order_acquire);
+    ma_uint64 write = ma_atomic_load_explicit_64(&pRing->pos->write_pos, ma_atomic_memory_order_acquire);
+    return (ma_uint32)(write - read);
+}
+
+/*
+ * Producer side: expose up to `count` writable samples as at most two
+ * contiguous segments of ring memory. Nothing is published until commit.
+ * Returns the number of samples reserved (pLen1 + pLen2).
+ */
+static ma_uint32 ma_bridge_ring_reserve_write(ma_bridge_ring* pRing, ma_uint32 count, void** ppSeg1, ma_uint32* pLen1, void** ppSeg2, ma_uint32* pLen2) {
+    ma_uint64 write = ma_atomic_load_explicit_64(&pRing->pos->write_pos, ma_atomic_memory_order_relaxed);
+    ma_uint64 read = ma_atomic_load_explicit_64(&pRing->pos->read_pos, ma_atomic_memory_order_acquire);
+    ma_uint32 space = pRing->capacity - (ma_uint32)(write - read);
+    if (count > space) count = space;
+
+    ma_uint32 index = ma_bridge_ring_index(pRing, write);
+    ma_uint32 first = pRing->capacity - index;
+    if (first > count) first = count;
+
+    *ppSeg1 = pRing->buffer + (size_t)index * pRing->bytes_per_sample;
+    *pLen1 = first;
+    *ppSeg2 = (count > first) ? pRing->buffer : NULL;
+    *pLen2 = count - first;
+    return count;
+}
+
+/* Producer side: publish `count` samples previously filled through reserve_write. */
+static void ma_bridge_ring_commit_write(ma_bridge_ring* pRing, ma_uint32 count) {
+    ma_uint64 write = ma_atomic_load_explicit_64(&pRing->pos->write_pos, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_64(&pRing->pos->write_pos, write + count, ma_atomic_memory_order_release);
+}
+
+/*
+ * Producer side: copy up to `count` samples in from `srcFormat`, converting in
+ * at most two contiguous passes. Returns samples written.
+ */
+static ma_uint32 ma_bridge_ring_write_from(ma_bridge_ring* pRing, const void* src, ma_format srcFormat, ma_uint32 count) {
+    void* pSeg1;
+    void* pSeg2;
+    ma_uint32 len1, len2;
+    count = ma_bridge_ring_reserve_write(pRing, count, &pSeg1, &len1, &pSeg2, &len2);
+    if (count == 0) return 0;
+
+    ma_bridge_pcm_convert(pSeg1, pRing->format, src, srcFormat, len1);
+    if (len2 > 0) {
+        ma_bridge_pcm_convert(pSeg2, pRing->format, (const ma_uint8*)src + (size_t)len1 * ma_get_bytes_per_sample(srcFormat), srcFormat, len2);
+    }
+
+    ma_bridge_ring_commit_write(pRing, count);
+    return count;
+}
+
+/* Producer side: copy up to `count` samples in, at most two contiguous copies. Returns samples written. */
+static ma_uint32 ma_bridge_ring_write(ma_bridge_ring* pRing, const void* src, ma_uint32 count) {
+    return ma_bridge_ring_write_from(pRing, src, pRing->format, count);
+}
+
+/*
+ * Consumer side: expose up to `count` readable samples as at most two
+ * contiguous segments of ring memory. Nothing is freed until release_read.
+ * Returns the number of samples acquired (pLen1 + pLen2).
+ */
+static ma_uint32 ma_bridge_ring_acquire_read(ma_bridge_ring* pRing, ma_uint32 count, void** ppSeg1, ma_uint32* pLen1, void** ppSeg2, ma_uint32* pLen2) {
+    ma_uint64 read = ma_atomic_load_explicit_64(&pRing->pos->read_pos, ma_atomic_memory_order_relaxed);
+    ma_uint64 write = ma_atomic_load_explicit_64(&pRing->pos->write_pos, ma_atomic_memory_order_acquire);
+    ma_uint32 available = (ma_uint32)(write - read);
+    if (count > available) count = available;
+
+    ma_uint32 index = ma_bridge_ring_index(pRing, read);
+    ma_uint32 first = pRing->capacity - index;
+    if (first > count) first = count;
+
+    *ppSeg1 = pRing->buffer + (size_t)index * pRing->bytes_per_sample;
+    *pLen1 = first;
+    *ppSeg2 = (count > first) ? pRing->buffer : NULL;
+    *pLen2 = count - first;
+    return count;
+}
+
+/* Consumer side: hand `count` samples previously acquired through acquire_read back to the producer. */
+static void ma_bridge_ring_release_read(ma_bridge_ring* pRing, ma_uint32 count) {
+    ma_uint64 read = ma_atomic_load_explicit_64(&pRing->pos->read_pos, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_64(&pRing->pos->read_pos, read + count, ma_atomic_memory_order_release);
+}
+
+/*
+ * Consumer side: copy up to `count` samples out as `dstFormat`, converting in at
+ * most two contiguous passes. Returns samples read.
+ */
+static ma_uint32 ma_bridge_ring_read(ma_bridge_ring* pRing, void* dst, ma_format dstFormat, ma_uint32 count) {
+    ma_uint64 read = ma_atomic_load_explicit_64(&pRing->pos->read_pos, ma_atomic_memory_order_relaxed);
+    ma_uint64 write = ma_atomic_load_explicit_64(&pRing->pos->write_pos, ma_atomic_memory_order_acquire);
+    ma_uint32 available = (ma_uint32)(write - read);
+    if (count > available) count = available;
+    if (count == 0) return 0;
+
+    ma_uint32 index = ma_bridge_ring_index(pRing, read);
+    ma_uint32 first = pRing->capacity - index;
+    if (first > count) first = count;
+    ma_bridge_pcm_convert(dst, dstFormat, pRing->buffer + (size_t)index * pRing->bytes_per_sample, pRing->format, first);
+    if (count > first) {
+        ma_bridge_pcm_convert((ma_uint8*)dst + (size_t)first * ma_get_bytes_per_sample(dstFormat), dstFormat, pRing->buffer, pRing->format, count - first);
+    }
+
+    ma_atomic_store_explicit_64(&pRing->pos->read_pos, read + count, ma_atomic_memory_order_release);
+    return count;
+}
+
+/* --- Callback Trace --- */
+
+MA_BRIDGE_EXPORT uint64_t ma_bridge_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER counter;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / freq.QuadPart) * 1000000000ull + (uint64_t)(counter.QuadPart % freq.QuadPart) * 1000000000ull / (uint64_t)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/*
+ * Fixed-size SPSC ring of callback records. The audio thread never waits:
+ * when the drain thread falls behind, new records are dropped and counted.
+ * The summary fields are owned by the drain thread.
+ */
+typedef struct {
+    ma_bridge_callback_trace records[MA_BRIDGE_TRACE_CAPACITY];
+    ma_uint64 write_index;   /* Audio thread (release) */
+    ma_uint64 read_index;    /* Drain thread (release) */
+    ma_uint64 dropped;       /* Audio thread */
+
+    ma_bridge_trace_summary summary;
+    ma_uint64 dropped_base;  /* `dropped` at the last summary reset */
+    ma_uint64 prev_start_ns;
+    ma_uint32 prev_frames;
+} ma_bridge_trace;
+
+static void ma_bridge_trace_reset_summary(ma_bridge_trace* pTrace) {
+    memset(&pTrace->summary, 0, sizeof(pTrace->summary));
+    pTrace->dropped_base = ma_atomic_load_explicit_64(&pTrace->dropped, ma_atomic_memory_order_relaxed);
+    pTrace->prev_start_ns = 0;
+    pTrace->prev_frames = 0;
+}
+
+/* Audio thread only. */
+static void ma_bridge_trace_push(ma_bridge_trace* pTrace, ma_uint64 start_ns, ma_uint64 end_ns, ma_uint32 frames_requested, ma_uint32 frames_delivered) {
+    ma_uint64 write = pTrace->write_index;
+    ma_uint64 read = ma_atomic_load_explicit_64(&pTrace->read_index, ma_atomic_memory_order_acquire);
+    if (write - read >= MA_BRIDGE_TRACE_CAPACITY) {
+        ma_atomic_store_explicit_64(&pTrace->dropped, pTrace->dropped + 1, ma_atomic_memory_order_relaxed);
+        return;
+    }
+
+    ma_bridge_callback_trace* pRecord = &pTrace->records[write & (MA_BRIDGE_TRACE_CAPACITY - 1)];
+    pRecord->start_ns = start_ns;
+    pRecord->end_ns = end_ns;
+    pRecord->frames_requested = frames_requested;
+    pRecord->frames_delivered = frames_delivered;
+    ma_atomic_store_explicit_64(&pTrace->write_index, write + 1, ma_atomic_memory_order_release);
+}
+
+static void ma_bridge_trace_fold(ma_bridge_trace* pTrace, const ma_bridge_callback_trace* pRecord, ma_uint32 sampleRate) {
+    ma_bridge_trace_summary* pSummary = &pTrace->summary;
+    pSummary->callbacks += 1;
+
+    if (sampleRate > 0 && pRecord->frames_requested > 0) {
+        double period_ns = (double)pRecord->frames_requested * 1e9 / (double)sampleRate;
+        double load = (double)(pRecord->end_ns - pRecord->start_ns) / period_ns;
+        pSummary->load_mean += (load - pSummary->load_mean) / (double)pSummary->callbacks;
+        if (load > pSummary->load_max) pSummary->load_max = load;
+    }
+
+    if (sampleRate > 0 && pTrace->prev_frames > 0) {
+        ma_int64 expected_ns = (ma_int64)((ma_uint64)pTrace->prev_frames * 1000000000ull / sampleRate);
+        ma_int64 error_ns = (ma_int64)(pRecord->start_ns - pTrace->prev_start_ns) - expected_ns;
+        if (pSummary->callbacks == 2) { /* First interval since the reset */
+            pSummary->interval_error_min_ns = pSummary->interval_error_max_ns = error_ns;
+        } else {
+            if (error_ns < pSummary->interval_error_min_ns) pSummary->interval_error_min_ns = error_ns;
+            if (error_ns > pSummary->interval_error_max_ns) pSummary->interval_error_max_ns = error_ns;
+        }
+
+        ma_uint64 error_us = (ma_uint64)(error_ns < 0 ? -error_ns : error_ns) / 1000;
+        ma_uint32 bin = 0;
+        while (error_us > 0 && bin < MA_BRIDGE_JITTER_BINS - 1) {
+            error_us >>= 1;
+            bin += 1;
+        }
+        pSummary->jitter_histogram[bin] += 1;
+    }
+
+    pTrace->prev_start_ns = pRecord->start_ns;
+    pTrace->prev_frames = pRecord->frames_requested;
+}
+
+/* Drain thread only. */
+static ma_uint32 ma_bridge_trace_drain(ma_bridge_trace* pTrace, ma_bridge_callback_trace* pOut, ma_uint32 max, ma_uint32 sampleRate) {
+    ma_uint64 read = pTrace->read_index;
+    ma_uint64 write = ma_atomic_load_explicit_64(&pTrace->write_index, ma_atomic_memory_order_acquire);
+    ma_uint32 count = (ma_uint32)(write - read);
+    if (pOut && count > max) count = max;
+
+    for (ma_uint32 i = 0; i < count; i += 1) {
+        const ma_bridge_callback_trace* pRecord = &pTrace->records[(read + i) & (MA_BRIDGE_TRACE_CAPACITY - 1)];
+        ma_bridge_trace_fold(pTrace, pRecord, sampleRate);
+        if (pOut) pOut[i] = *pRecord;
+    }
+
+    ma_atomic_store_explicit_64(&pTrace->read_index, read + count, ma_atomic_memory_order_release);
+    return count;
+}
+
+
+/* --- Stream Clock --- */
+
+/* (frame position, host time) pair published by the audio thread under a seqlock */
+typedef struct {
+    ma_uint32 sequence;
+    ma_uint64 frame_position;
+    ma_uint64 host_ns;
+} ma_bridge_clock;
+
+/* Audio thread only. */
+static void ma_bridge_clock_publish(ma_bridge_clock* pClock, ma_uint64 frame_position, ma_uint64 host_ns) {
+    ma_uint32 seq = pClock->sequence;
+    ma_atomic_store_explicit_32(&pClock->sequence, seq + 1, ma_atomic_memory_order_relaxed);
+    ma_atomic_thread_fence(ma_atomic_memory_order_release);
+    ma_atomic_store_explicit_64(&pClock->frame_position, frame_position, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_64(&pClock->host_ns, host_ns, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_32(&pClock->sequence, seq + 2, ma_atomic_memory_order_release);
+}
+
+/* Any thread. Returns -1 until the first publish. */
+static int ma_bridge_clock_read(ma_bridge_clock* pClock, uint64_t* frame_position, uint64_t* host_time_ns) {
+    ma_uint32 seq;
+    ma_uint64 position, host_ns;
+    do {
+        seq = ma_atomic_load_explicit_32(&pClock->sequence, ma_atomic_memory_order_acquire);
+        position = ma_atomic_load_explicit_64(&pClock->frame_position, ma_atomic_memory_order_relaxed);
+        host_ns = ma_atomic_load_explicit_64(&pClock->host_ns, ma_atomic_memory_order_relaxed);
+        ma_atomic_thread_fence(ma_atomic_memory_order_acquire);
+    } while ((seq & 1) != 0 || seq != ma_atomic_load_explicit_32(&pClock->sequence, ma_atomic_memory_order_relaxed));
+
+    if (host_ns == 0) return -1;
+    if (frame_position) *frame_position = position;
+    if (host_time_ns) *host_time_ns = host_ns;
+    return 0;
+}
+
+static void ma_bridge_clock_reset(ma_bridge_clock* pClock) {
+    pClock->sequence = 0;
+    pClock->frame_position = 0;
+    pClock->host_ns = 0;
+}
+
+/* --- Wait Primitives --- */
+
+/*
+ * Lets a producer sleep until the audio callback has drained enough of the
+ * FIFO. Several threads may sleep on one waiter (a duplex stream's producer
+ * and capture reader), so every signal wakes all of them: futex /
+ * WaitOnAddress wake-all, a Mach signal-all, or one POSIX post per
+ * registered waiter. The callback only ever signals (never a lock) and skips
+ * even that when nobody is waiting. Sleepers re-check their condition, so a
+ * spare wake only costs a loop iteration.
+ */
+typedef struct {
+    ma_uint32 sequence;  /* Bumped by every signal; the futex / WaitOnAddress word */
+    ma_uint32 waiters;
+#if defined(__APPLE__)
+    semaphore_t semaphore; /* Mach: plain C, so ARC (the .m forwarders) does not manage it */
+#elif !defined(__linux__)
+    sem_t semaphore;
+#endif
+    ma_bool32 initialized;
+} ma_bridge_waiter;
+
+static void ma_bridge_waiter_init(ma_bridge_waiter* pWaiter) {
+    if (pWaiter->initialized) return;
+    pWaiter->sequence = 0;
+    pWaiter->waiters = 0;
+#if defined(__APPLE__)
+    semaphore_create(mach_task_self(), &pWaiter->semaphore, SYNC_POLICY_FIFO, 0);
+#elif !defined(__linux__)
+    sem_init(&pWaiter->semaphore, 0, 0);
+#endif
+    pWaiter->initialized = MA_TRUE;
+}
+
+static void ma_bridge_waiter_uninit(ma_bridge_waiter* pWaiter) {
+    if (!pWaiter->initialized) return;
+#if defined(__APPLE__)
+    semaphore_destroy(mach_task_self(), pWaiter->semaphore);
+#elif !defined(__linux__)
+    sem_destroy(&pWaiter->semaphore);
+#endif
+    pWaiter->initialized = MA_FALSE;
+}
+
+/* Wait-free; safe on the audio thread. */
+static void ma_bridge_waiter_signal(ma_bridge_waiter* pWaiter) {
+    ma_atomic_fetch_add_explicit_32(&pWaiter->sequence, 1, ma_atomic_memory_order_seq_cst);
+    ma_uint32 waiters = ma_atomic_load_explicit_32(&pWaiter->waiters, ma_atomic_memory_order_seq_cst);
+    if (waiters == 0 || !pWaiter->initialized) return;
+#if defined(__linux__)
+    syscall(SYS_futex, &pWaiter->sequence, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#elif defined(_WIN32)
+    WakeByAddressAll((PVOID)&pWaiter->sequence);
+#elif defined(__APPLE__)
+    /* Signal-all does not prepost: if nobody is blocked yet, leave one count for the sleeper about to block */
+    if (semaphore_signal_all(pWaiter->semaphore) == KERN_NOT_WAITING) semaphore_signal(pWaiter->semaphore);
+#else
+    for (ma_uint32 i = 0; i < waiters; i += 1) sem_post(&pWaiter->semaphore);
+#endif
+}
+
+/* Sleep until signaled (or `sequence` has moved past `seen`), at most timeout_ns. */
+static void ma_bridge_waiter_sleep(ma_bridge_waiter* pWaiter, ma_uint32 seen, ma_uint64 timeout_ns) {
+#if defined(__linux__)
+    struct timespec ts;
+    ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+    ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+    syscall(SYS_futex, &pWaiter->sequence, FUTEX_WAIT_PRIVATE, seen, &ts, NULL, 0);
+#elif defined(_WIN32)
+    WaitOnAddress((volatile VOID*)&pWaiter->sequence, &seen, sizeof(seen), (DWORD)((timeout_ns + 999999) / 1000000));
+#elif defined(__APPLE__)
+    if (ma_atomic_load_explicit_32(&pWaiter->sequence, ma_atomic_memory_order_seq_cst) != seen) return;
+    mach_timespec_t ts;
+    ts.tv_sec = (unsigned int)(timeout_ns / 1000000000ull);
+    ts.tv_nsec = (clock_res_t)(timeout_ns % 1000000000ull);
+    semaphore_timedwait(pWaiter->semaphore, ts);
+#else
+    if (ma_atomic_load_explicit_32(&pWaiter->sequence, ma_atomic_memory_order_seq_cst) != seen) return;
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ma_uint64 deadline = (ma_uint64)ts.tv_nsec + timeout_ns;
+    ts.tv_sec += (time_t)(deadline / 1000000000ull);
+    ts.tv_nsec = (long)(deadline % 1000000000ull);
+    sem_timedwait(&pWaiter->semaphore, &ts);
+#endif
+}
+
+
+/* --- Low-Water Notification --- */
+
+/*
+ * Minimal mirror of Dart's Dart_CObject (dart_native_api.h): only the
+ * variants the bridge posts (int64, string, array). The union pad keeps the
+ * full struct size.
+ */
+#define MA_BRIDGE_DART_COBJECT_INT64  3
+#define MA_BRIDGE_DART_COBJECT_STRING 5
+#define MA_BRIDGE_DART_COBJECT_ARRAY  6
+
+typedef struct ma_bridge_dart_cobject {
+    int32_t type;
+    union {
+        int64_t as_int64;
+        const char* as_string;
+        struct {
+            intptr_t length;
+            struct ma_bridge_dart_cobject** values;
+        } as_array;
+        void* pad[5];
+    } value;
+} ma_bridge_dart_cobject;
+
+/* Dart_PostCObject, as handed over by NativeApi.postCObject */
+typedef int8_t (*ma_bridge_post_cobject_proc)(int64_t port, ma_bridge_dart_cobject* message);
+
+#define MA_BRIDGE_NOTIFY_NONE 0xFFFFFFFFu
+
+/*
+ * The callback only flips `pending` and signals the waiter; the handoff
+ * thread makes the Dart_PostCObject call, which may allocate and lock.
+ * Edge-triggered: one event per crossing below the watermark, re-armed
+ * once the fill climbs back to it.
+ */
+typedef struct {
+    ma_uint32 watermark_frames; /* 0 = disabled */
+    ma_bool32 armed;            /* Audio thread only */
+    ma_uint32 pending;          /* Fill (frames) at the crossing, or MA_BRIDGE_NOTIFY_NONE */
+    ma_uint32 running;
+    ma_bridge_waiter waiter;
+    ma_thread thread;
+    ma_bool32 thread_started;
+    ma_bridge_post_cobject_proc post;
+    int64_t port;
+} ma_bridge_notifier;
+
+/* Audio thread: called after each read with the remaining fill. */
+static MA_INLINE void ma_bridge_notifier_update(ma_bridge_notifier* pNotifier, ma_uint32 fill_frames) {
+    ma_uint32 watermark = ma_atomic_load_explicit_32(&pNotifier->watermark_frames, ma_atomic_memory_order_relaxed);
+    if (watermark == 0) return;
+
+    if (fill_frames >= watermark) {
+        pNotifier->armed = MA_TRUE;
+    } else if (pNotifier->armed) {
+        pNotifier->armed = MA_FALSE;
+        ma_atomic_exchange_explicit_32(&pNotifier->pending, fill_frames, ma_atomic_memory_order_release);
+        ma_bridge_waiter_signal(&pNotifier->waiter);
+    }
+}
+
+static ma_thread_result MA_THREADCALL ma_bridge_notifier_thread(void* pData) {
+    ma_bridge_notifier* pNotifier = (ma_bridge_notifier*)pData;
+    ma_bridge_waiter* pWaiter = &pNotifier->waiter;
+
+    ma_atomic_fetch_add_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    for (;;) {
+        ma_uint32 seen = ma_atomic_load_explicit_32(&pWaiter->sequence, ma_atomic_memory_order_seq_cst);
+        if (!ma_atomic_load_explicit_32(&pNotifier->running, ma_atomic_memory_order_acquire)) break;
+
+        ma_uint32 pending = ma_atomic_exchange_explicit_32(&pNotifier->pending, MA_BRIDGE_NOTIFY_NONE, ma_atomic_memory_order_acquire);
+        if (pending != MA_BRIDGE_NOTIFY_NONE) {
+            ma_bridge_dart_cobject message;
+            message.type = MA_BRIDGE_DART_COBJECT_INT64;
+            message.value.as_int64 = (int64_t)pending;
+            pNotifier->post(pNotifier->port, &message);
+            continue;
+        }
+        ma_bridge_waiter_sleep(pWaiter, seen, 100000000ull); /* Periodic wake only to observe shutdown */
+    }
+    ma_atomic_fetch_sub_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    return (ma_thread_result)0;
+}
+
+static void ma_bridge_notifier_stop(ma_bridge_notifier* pNotifier) {
+    ma_atomic_store_explicit_32(&pNotifier->watermark_frames, 0, ma_atomic_memory_order_relaxed);
+    if (!pNotifier->thread_started) return;
+
+    ma_atomic_store_explicit_32(&pNotifier->running, 0, ma_atomic_memory_order_release);
+    ma_bridge_waiter_signal(&pNotifier->waiter);
+    ma_thread_wait(&pNotifier->thread);
+    pNotifier->thread_started = MA_FALSE;
+}
+
+static int ma_bridge_notifier_start(ma_bridge_notifier* pNotifier, ma_bridge_post_cobject_proc post, int64_t port, ma_uint32 watermark_frames) {
+    ma_bridge_notifier_stop(pNotifier);
+
+    pNotifier->post = post;
+    pNotifier->port = port;
+    pNotifier->armed = MA_TRUE;
+    pNotifier->pending = MA_BRIDGE_NOTIFY_NONE;
+    pNotifier->running = 1;
+    ma_bridge_waiter_init(&pNotifier->waiter); /* Kept until stream destroy: a callback may still signal it */
+    if (ma_thread_create(&pNotifier->thread, ma_thread_priority_default, 0, ma_bridge_notifier_thread, pNotifier, NULL) != MA_SUCCESS) {
+        return -1;
+    }
+    pNotifier->thread_started = MA_TRUE;
+    ma_atomic_store_explicit_32(&pNotifier->watermark_frames, watermark_frames, ma_atomic_memory_order_release);
+    return 0;
+}
+
+
+/* --- Logging --- */
+
+/*
+ * Bridge messages go into a bounded multi-producer ring (a per-slot sequence
+ * number marks each slot free or full, so writers only contend on one CAS).
+ * A writer stores the format string and its arguments as raw values; it
+ * never formats, blocks, allocates or takes the stdio lock, so audio
+ * threads may log. If the ring is full the message is dropped and counted.
+ *
+ * A background thread formats and delivers each message, in order, to
+ * stdout, a native callback and/or a Dart port, and reports drops. It is
+ * started from control-thread entry points (context, stream or sink setup)
+ * and stopped by ma_bridge_deinit; messages logged while it is not running
+ * wait in the ring.
+ */
+#define MA_BRIDGE_LOG_CAPACITY     256 /* Records, power of two */
+#define MA_BRIDGE_LOG_MAX_ARGS     8
+#define MA_BRIDGE_LOG_MESSAGE_SIZE 256 /* Formatted, on the drain side */
+#define MA_BRIDGE_LOG_POLL_NS      100000000ull /* Drain at least every 100 ms */
+
+typedef union {
+    ma_int64 i;    /* Integers (unsigned ones by their bit pattern) and chars */
+    double f;
+    const char* s; /* Must outlive the message: literals or ma_get_*_name() */
+    const void* p;
+} ma_bridge_log_arg;
+
+typedef struct {
+    ma_uint32 sequence;  /* Free for position p when sequence + index == p, full when == p + 1 */
+    ma_int32 level;
+    ma_uint32 arg_count;
+    ma_uint64 time_ns;
+    const char* format;  /* A literal at every call site */
+    ma_bridge_log_arg args[MA_BRIDGE_LOG_MAX_ARGS];
+} ma_bridge_log_record;
+
+typedef struct {
+    ma_bridge_log_proc proc;
+    void* user_data;
+} ma_bridge_log_callback;
+
+typedef struct {
+    ma_bridge_post_cobject_proc post;
+    int64_t port;
+} ma_bridge_log_port;
+
+static struct {
+    ma_bridge_log_record records[MA_BRIDGE_LOG_CAPACITY];
+    ma_uint32 write_pos;
+    ma_uint32 read_pos;         /* Drain side, under `draining` */
+    ma_uint32 level;            /* Minimum ma_bridge_log_level recorded */
+    ma_uint32 to_stdout;
+    ma_uint64 dropped;
+    ma_uint64 dropped_reported; /* Drain side */
+    ma_bridge_log_callback* callback; /* Each sink is swapped as one pointer */
+    ma_bridge_log_port* port;
+    ma_uint32 draining;         /* One drainer at a time, so delivery stays in order */
+    ma_uint32 thread_state;     /* 0 = stopped, 1 = starting, 2 = running, 3 = stopping */
+    ma_uint32 running;
+    ma_bridge_waiter waiter;
+    ma_thread thread;
+} g_log = { .level = ma_bridge_log_level_info, .to_stdout = 1 };
+
+static MA_INLINE ma_bool32 ma_bridge_log_is_flag(char c) {
+    return c == '-' || c == '+' || c == ' ' || c == '#' || c == '.' || (c >= '0' && c <= '9');
+}
+
+static const char* ma_bridge_log_level_name(ma_int32 level) {
+    switch (level) {
+        case ma_bridge_log_level_debug:   return "debug";
+        case ma_bridge_log_level_info:    return "info";
+        case ma_bridge_log_level_warning: return "warning";
+        default:                          return "error";
+    }
+}
+
+/*
+ * Drain side: expand a record's format with its stored arguments, one
+ * conversion at a time. Integer conversions are widened to long long, the
+ * width the writer stored them at.
+ */
+static void ma_bridge_log_format(char* pOut, size_t size, const ma_bridge_log_record* pRecord) {
+    size_t length = 0;
+    ma_uint32 arg = 0;
+    const char* c = pRecord->format;
+
+    while (*c && length + 1 < size) {
+        if (*c != '%') {
+            pOut[length++] = *c++;
+            continue;
+        }
+        const char* start = c++;
+        if (*c == '%') {
+            pOut[length++] = '%';
+            c++;
+            continue;
+        }
+        while (ma_bridge_log_is_flag(*c)) c++;
+        const char* modifiers = c;
+        while (*c == 'l' || *c == 'z' || *c == 'h') c++;
+        char conversion = *c;
+        if (conversion == '\0') break;
+        c++;
+
+        char spec[24];
+        size_t spec_length = (size_t)(modifiers - start);
+        if (spec_length > sizeof(spec) - 4) spec_length = sizeof(spec) - 4;
+        memcpy(spec, start, spec_length);
+
+        const ma_bridge_log_arg* pArg = (arg < pRecord->arg_count) ? &pRecord->args[arg++] : NULL;
+        size_t room = size - length;
+        int written;
+        if (pArg == NULL) {
+            written = snprintf(pOut + length, room, "%.*s", (int)(c - start), start); /* Unsupported: as written */
+        } else if (conversion == 'd' || conversion == 'i' || conversion == 'u' || conversion == 'x' || conversion == 'X' || conversion == 'o') {
+            spec[spec_length++] = 'l';
+            spec[spec_length++] = 'l';
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            if (conversion == 'd' || conversion == 'i') {
+                written = snprintf(pOut + length, room, spec, (long long)pArg->i);
+            } else {
+                written = snprintf(pOut + length, room, spec, (unsigned long long)pArg->i);
+            }
+        } else {
+            spec[spec_length++] = conversion;
+            spec[spec_length] = '\0';
+            switch (conversion) {
+                case 'c': written = snprintf(pOut + length, room, spec, (int)pArg->i); break;
+                case 's': written = snprintf(pOut + length, room, spec, pArg->s ? pArg->s : "(null)"); break;
+                case 'p': written = snprintf(pOut + length, room, spec, pArg->p); break;
+                default:  written = snprintf(pOut + length, room, spec, pArg->f); break;
+            }
+        }
+        if (written < 0) break;
+        length += (size_t)written < room ? (size_t)written : room - 1;
+    }
+    pOut[length] = '\0';
+}
+
+/* Drain side: hand one message to every sink. */
+static void ma_bridge_log_deliver(ma_int32 level, ma_uint64 time_ns, const char* message) {
+    if (ma_atomic_load_explicit_32(&g_log.to_stdout, ma_atomic_memory_order_relaxed)) {
+        if (level >= ma_bridge_log_level_warning) {
+            printf("[miniaudio_bridge] %s: %s\n", ma_bridge_log_level_name(level), message);
+        } else {
+            printf("[miniaudio_bridge] %s\n", message);
+        }
+    }
+
+    const ma_bridge_log_callback* pCallback = (const ma_bridge_log_callback*)ma_atomic_load_explicit_ptr((volatile void**)&g_log.callback, ma_atomic_memory_order_acquire);
+    if (pCallback) pCallback->proc(pCallback->user_data, level, time_ns, message);
+
+    const ma_bridge_log_port* pPort = (const ma_bridge_log_port*)ma_atomic_load_explicit_ptr((volatile void**)&g_log.port, ma_atomic_memory_order_acquire);
+    if (pPort) {
+        // [level, time_ns, message]; Dart_PostCObject copies it all
+        ma_bridge_dart_cobject fields[3];
+        ma_bridge_dart_cobject* values[3] = { &fields[0], &fields[1], &fields[2] };
+        ma_bridge_dart_cobject message_object;
+        fields[0].type = MA_BRIDGE_DART_COBJECT_INT64;
+        fields[0].value.as_int64 = level;
+        fields[1].type = MA_BRIDGE_DART_COBJECT_INT64;
+        fields[1].value.as_int64 = (int64_t)time_ns;
+        fields[2].type = MA_BRIDGE_DART_COBJECT_STRING;
+        fields[2].value.as_string = message;
+        message_object.type = MA_BRIDGE_DART_COBJECT_ARRAY;
+        message_object.value.as_array.length = 3;
+        message_object.value.as_array.values = values;
+        pPort->post(pPort->port, &message_object);
+    }
+}
+
+/* Control or drain thread. Sleeps rather than spins: the holder may be inside a sink. */
+static void ma_bridge_log_lock_drain(void) {
+    ma_uint32 expected = 0;
+    while (!ma_atomic_compare_exchange_strong_explicit_32(&g_log.draining, &expected, 1, ma_atomic_memory_order_acquire, ma_atomic_memory_order_relaxed)) {
+        expected = 0;
+        ma_sleep(1);
+    }
+}
+
+static void ma_bridge_log_unlock_drain(void) {
+    ma_atomic_store_explicit_32(&g_log.draining, 0, ma_atomic_memory_order_release);
+}
+
+/* Pop and deliver everything queued, in order. */
+static void ma_bridge_log_drain(void) {
+    char message[MA_BRIDGE_LOG_MESSAGE_SIZE];
+    ma_bridge_log_lock_drain();
+
+    for (;;) {
+        ma_uint32 pos = g_log.read_pos;
+        ma_uint32 index = pos & (MA_BRIDGE_LOG_CAPACITY - 1);
+        ma_bridge_log_record* pRecord = &g_log.records[index];
+        ma_uint32 sequence = ma_atomic_load_explicit_32(&pRecord->sequence, ma_atomic_memory_order_acquire) + index;
+        if (sequence != pos + 1) break; /* Empty (or still being written) */
+
+        ma_int32 level = pRecord->level;
+        ma_uint64 time_ns = pRecord->time_ns;
+        ma_bridge_log_format(message, sizeof(message), pRecord);
+        ma_atomic_store_explicit_32(&pRecord->sequence, pos + MA_BRIDGE_LOG_CAPACITY - index, ma_atomic_memory_order_release);
+        g_log.read_pos = pos + 1;
+        ma_bridge_log_deliver(level, time_ns, message);
+    }
+
+    ma_uint64 dropped = ma_atomic_load_explicit_64(&g_log.dropped, ma_atomic_memory_order_relaxed);
+    if (dropped > g_log.dropped_reported) {
+        snprintf(message, sizeof(message), "Log overflow: %llu messages dropped", (unsigned long long)(dropped - g_log.dropped_reported));
+        g_log.dropped_reported = dropped;
+        ma_bridge_log_deliver(ma_bridge_log_level_warning, ma_bridge_now_ns(), message);
+    }
+
+    ma_bridge_log_unlock_drain();
+}
+
+static ma_thread_result MA_THREADCALL ma_bridge_log_thread(void* pData) {
+    ma_bridge_waiter* pWaiter = &g_log.waiter;
+    (void)pData;
+
+    ma_atomic_fetch_add_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    for (;;) {
+        ma_uint32 seen = ma_atomic_load_explicit_32(&pWaiter->sequence, ma_atomic_memory_order_seq_cst);
+        ma_bool32 running = ma_atomic_load_explicit_32(&g_log.running, ma_atomic_memory_order_acquire);
+        ma_bridge_log_drain();
+        if (!running) break; /* Drained once more after the stop request */
+        ma_bridge_waiter_sleep(pWaiter, seen, MA_BRIDGE_LOG_POLL_NS);
+    }
+    ma_atomic_fetch_sub_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    return (ma_thread_result)0;
+}
+
+/* Control thread. No-op while the thread runs. */
+static void ma_bridge_log_start(void) {
+    ma_uint32 expected = 0;
+    if (!ma_atomic_compare_exchange_strong_explicit_32(&g_log.thread_state, &expected, 1, ma_atomic_memory_order_acq_rel, ma_atomic_memory_order_relaxed)) return;
+
+    ma_bridge_waiter_init(&g_log.waiter); /* Kept for the process: writers may signal it at any time */
+    ma_atomic_store_explicit_32(&g_log.running, 1, ma_atomic_memory_order_release);
+    if (ma_thread_create(&g_log.thread, ma_thread_priority_default, 0, ma_bridge_log_thread, NULL, NULL) != MA_SUCCESS) {
+        ma_atomic_store_explicit_32(&g_log.thread_state, 0, ma_atomic_memory_order_release); /* Retried by the next start */
+        return;
+    }
+    ma_atomic_store_explicit_32(&g_log.thread_state, 2, ma_atomic_memory_order_release);
+}
+
+/* Control thread: deliver what is queued, then join the thread. */
+static void ma_bridge_log_stop(void) {
+    ma_uint32 expected = 2;
+    if (!ma_atomic_compare_exchange_strong_explicit_32(&g_log.thread_state, &expected, 3, ma_atomic_memory_order_acq_rel, ma_atomic_memory_order_relaxed)) return;
+
+    ma_atomic_store_explicit_32(&g_log.running, 0, ma_atomic_memory_order_release);
+    ma_bridge_waiter_signal(&g_log.waiter);
+    ma_thread_wait(&g_log.thread);
+    ma_atomic_store_explicit_32(&g_log.thread_state, 0, ma_atomic_memory_order_release);
+}
+
+static void ma_bridge_log(ma_bridge_log_level level, const char* format, ...) MA_ATTRIBUTE_FORMAT(2, 3);
+
+/* Any thread, audio threads included. */
+static void ma_bridge_log(ma_bridge_log_level level, const char* format, ...) {
+    if ((ma_uint32)level < ma_atomic_load_explicit_32(&g_log.level, ma_atomic_memory_order_relaxed)) return;
+
+    // Claim the slot at write_pos once it is free
+    ma_uint32 pos = ma_atomic_load_explicit_32(&g_log.write_pos, ma_atomic_memory_order_relaxed);
+    ma_bridge_log_record* pRecord;
+    ma_uint32 index;
+    for (;;) {
+        index = pos & (MA_BRIDGE_LOG_CAPACITY - 1);
+        pRecord = &g_log.records[index];
+        ma_uint32 sequence = ma_atomic_load_explicit_32(&pRecord->sequence, ma_atomic_memory_order_acquire) + index;
+        ma_int32 diff = (ma_int32)(sequence - pos);
+        if (diff == 0) {
+            if (ma_atomic_compare_exchange_weak_explicit_32(&g_log.write_pos, &pos, pos + 1, ma_atomic_memory_order_relaxed, ma_atomic_memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            ma_atomic_fetch_add_explicit_64(&g_log.dropped, 1, ma_atomic_memory_order_relaxed);
+            return;
+        } else {
+            pos = ma_atomic_load_explicit_32(&g_log.write_pos, ma_atomic_memory_order_relaxed);
+        }
+    }
+
+    // Store the arguments as the format's conversions say; formatting waits for the drain
+    ma_uint32 count = 0;
+    va_list args;
+    va_start(args, format);
+    for (const char* c = format; *c && count < MA_BRIDGE_LOG_MAX_ARGS; c++) {
+        if (*c != '%') continue;
+        c++;
+        if (*c == '%') continue;
+        while (ma_bridge_log_is_flag(*c)) c++;
+        int longs = 0;
+        ma_bool32 size = MA_FALSE;
+        for (; *c == 'l' || *c == 'z' || *c == 'h'; c++) {
+            if (*c == 'l') longs++;
+            if (*c == 'z') size = MA_TRUE;
+        }
+
+        ma_bridge_log_arg* pArg = &pRecord->args[count];
+        switch (*c) {
+            case 'd': case 'i': case 'c':
+                pArg->i = size ? (ma_int64)va_arg(args, size_t) : (longs >= 2 ? (ma_int64)va_arg(args, long long) : (longs == 1 ? (ma_int64)va_arg(args, long) : (ma_int64)va_arg(args, int)));
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                pArg->i = size ? (ma_int64)va_arg(args, size_t) : (longs >= 2 ? (ma_int64)va_arg(args, unsigned long long) : (longs == 1 ? (ma_int64)va_arg(args, unsigned long) : (ma_int64)va_arg(args, unsigned int)));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+                pArg->f = va_arg(args, double);
+                break;
+            case 's':
+                pArg->s = va_arg(args, const char*);
+                break;
+            case 'p':
+                pArg->p = va_arg(args, const void*);
+                break;
+            default:
+                goto done; /* Unsupported (or a truncated format): the rest is printed as written */
+        }
+        count++;
+    }
+done:
+    va_end(args);
+
+    pRecord->format = format;
+    pRecord->arg_count = count;
+    pRecord->level = (ma_int32)level;
+    pRecord->time_ns = ma_bridge_now_ns();
+    ma_atomic_store_explicit_32(&pRecord->sequence, pos + 1 - index, ma_atomic_memory_order_release);
+    ma_bridge_waiter_signal(&g_log.waiter);
+}
+
+/* %s arguments are stored as pointers: pass only strings that outlive the message. */
+#define MA_BRIDGE_LOG(level, ...) ma_bridge_log(level, __VA_ARGS__)
+
+MA_BRIDGE_EXPORT void ma_bridge_log_set_level(int32_t level) {
+    if (level < ma_bridge_log_level_debug) level = ma_bridge_log_level_debug;
+    ma_atomic_store_explicit_32(&g_log.level, (ma_uint32)level, ma_atomic_memory_order_relaxed);
+}
 
 MA_BRIDGE_EXPORT void ma_bridge_set_log_enabled(int enabled) {
-    g_log_enabled = enabled;
-    // printf("[miniaudio_bridge] Logging %s\n", enabled ? "ENABLED" : "DISABLED");
+    ma_bridge_log_set_level(enabled ? ma_bridge_log_level_debug : ma_bridge_log_level_info);
 }
 
-/* Device FIFO state (legacy/stream mode) */
-static int16_t* g_fifo = NULL;
-static int g_fifo_capacity = 0;
-static volatile int* g_read_pos = NULL;
-static volatile int* g_write_pos = NULL;
-static int g_channels = 2; /* Synced with device config */
-static uint64_t g_frames_consumed = 0;
+MA_BRIDGE_EXPORT void ma_bridge_log_set_stdout(int32_t enabled) {
+    ma_atomic_store_explicit_32(&g_log.to_stdout, enabled ? 1 : 0, ma_atomic_memory_order_relaxed);
+}
 
+/* Swap a sink, then free the old one once no drain can still be using it. */
+static void ma_bridge_log_replace_sink(void** ppSink, void* pNew) {
+    void* pOld = ma_atomic_exchange_explicit_ptr((volatile void**)ppSink, pNew, ma_atomic_memory_order_acq_rel);
+    if (pOld) {
+        ma_bridge_log_lock_drain();
+        ma_bridge_log_unlock_drain();
+        free(pOld);
+    }
+    if (pNew) ma_bridge_log_start();
+}
 
-/* --- Internal Helpers --- */
+MA_BRIDGE_EXPORT void ma_bridge_log_set_callback(ma_bridge_log_proc proc, void* user_data) {
+    ma_bridge_log_callback* pCallback = NULL;
+    if (proc) {
+        pCallback = (ma_bridge_log_callback*)malloc(sizeof(*pCallback));
+        if (!pCallback) return;
+        pCallback->proc = proc;
+        pCallback->user_data = user_data;
+    }
+    ma_bridge_log_replace_sink((void**)&g_log.callback, pCallback);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_log_set_port(void* post_cobject, int64_t port) {
+    ma_bridge_log_port* pPort = NULL;
+    if (post_cobject) {
+        pPort = (ma_bridge_log_port*)malloc(sizeof(*pPort));
+        if (!pPort) return;
+        pPort->post = (ma_bridge_post_cobject_proc)post_cobject;
+        pPort->port = port;
+    }
+    ma_bridge_log_replace_sink((void**)&g_log.port, pPort);
+}
+
+MA_BRIDGE_EXPORT uint64_t ma_bridge_log_get_dropped(void) {
+    return ma_atomic_load_explicit_64(&g_log.dropped, ma_atomic_memory_order_relaxed);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_log_flush(void) {
+    ma_bridge_log_drain();
+}
+
+
+/* --- Offline Clock --- */
+
+/*
+ * Offline streams have no device: a pump runs the regular callback path
+ * (FIFO, rate control, resampler, telemetry) on a virtual clock, as fast as
+ * possible or paced to a multiple of real time. Each period's timestamp can
+ * be offset by seeded jitter, so runs on headless machines are repeatable.
+ */
+typedef struct {
+    ma_bool32 enabled;
+    ma_uint32 period_frames;
+    ma_uint64 origin_ns;     /* Virtual time of frame 0 */
+    ma_uint64 frames;        /* Frames pumped; virtual time never drifts from it */
+    double speed;            /* Virtual seconds per real second; 0 = as fast as possible */
+    ma_uint32 jitter_ns;     /* Max +/- offset of a period's timestamp */
+    ma_uint32 rng;           /* xorshift32 state */
+    void* output;            /* One period in the device format, discarded */
+    ma_uint32 running;
+    ma_bridge_waiter waiter; /* Cuts paced sleeps short on stop */
+    ma_thread thread;
+    ma_bool32 thread_started;
+} ma_bridge_offline;
+
+static void ma_bridge_offline_set_clock(ma_bridge_offline* pOffline, double speed, ma_uint32 jitter_ns, ma_uint32 seed, ma_uint32 sample_rate) {
+    // Keep periods in order: at most half a period either way
+    ma_uint64 max_jitter_ns = (ma_uint64)pOffline->period_frames * 500000000ull / sample_rate;
+    pOffline->speed = (speed > 0) ? speed : 0;
+    pOffline->jitter_ns = (jitter_ns > max_jitter_ns) ? (ma_uint32)max_jitter_ns : jitter_ns;
+    pOffline->rng = seed ? seed : 1;
+}
+
+/* Nominal virtual time of the next period */
+static ma_uint64 ma_bridge_offline_now_ns(const ma_bridge_offline* pOffline, ma_uint32 sample_rate) {
+    return pOffline->origin_ns + pOffline->frames * 1000000000ull / sample_rate;
+}
+
+/* Timestamp of the next period, jitter included */
+static ma_uint64 ma_bridge_offline_period_start_ns(ma_bridge_offline* pOffline, ma_uint32 sample_rate) {
+    ma_uint64 start_ns = ma_bridge_offline_now_ns(pOffline, sample_rate);
+    if (pOffline->jitter_ns == 0) return start_ns;
+
+    ma_uint32 x = pOffline->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pOffline->rng = x;
+    return start_ns - pOffline->jitter_ns + (x % (2ull * pOffline->jitter_ns + 1));
+}
+
+/* --- Dynamic Rate Control --- */
+
+/*
+ * Keeps the FIFO near a target fill by nudging the resampling ratio
+ * (input / output) around a nominal base_ratio * speed. The fill is smoothed
+ * with an EMA, then a PI controller acts on the normalized error. The
+ * integral absorbs a constant clock drift, so the proportional term can
+ * stay small enough not to wobble the pitch.
+ *
+ * The controller runs on whichever thread resamples: the producer (push
+ * mode) or the audio thread (pull mode). Control threads never touch its
+ * state; they write `pending` and bump `generation`, and the controller
+ * adopts the new parameters at its next update.
+ */
+#define MA_BRIDGE_DRC_DEFAULT_MAX_SKEW 0.005f /* +-0.5%: inaudible pitch change */
+#define MA_BRIDGE_DRC_SMOOTHING        0.1f   /* EMA weight of the newest fill sample */
+#define MA_BRIDGE_DRC_KI_PER_KP        0.01f  /* Integral gain relative to proportional, per update */
+
+typedef struct {
+    float base_ratio;         /* Source rate / device rate, or a ratio set explicitly */
+    float speed;              /* User playback speed, independent of the correction */
+    ma_uint32 target_frames;  /* Desired fill; 0 = half the FIFO */
+    float max_skew;           /* Correction limit as a fraction of the nominal ratio; 0 = off */
+} ma_bridge_drc_params;
+
+typedef struct {
+    ma_bridge_drc_params params;  /* In use; controller thread only */
+    ma_bridge_drc_params pending; /* Written field by field (atomically) by control threads */
+    ma_uint32 generation;         /* Bumped after each pending change */
+    ma_uint32 applied_generation; /* Controller thread only */
+    float fill_smoothed;          /* Frames */
+    float integral;
+    float ratio;                  /* Last ratio applied; atomic, also read by control threads */
+    ma_bool32 primed;
+} ma_bridge_drc;
+
+/* While nothing runs the controller yet */
+static void ma_bridge_drc_init(ma_bridge_drc* pDrc) {
+    pDrc->params.base_ratio = 1.0f;
+    pDrc->params.speed = 1.0f;
+    pDrc->params.target_frames = 0;
+    pDrc->params.max_skew = MA_BRIDGE_DRC_DEFAULT_MAX_SKEW;
+    pDrc->pending = pDrc->params;
+    pDrc->generation = 0;
+    pDrc->applied_generation = 0;
+    pDrc->integral = 0;
+    pDrc->ratio = 1.0f;
+    pDrc->primed = MA_FALSE;
+}
+
+/* Control thread, after changing `pending`: hand it to the controller. */
+static void ma_bridge_drc_publish(ma_bridge_drc* pDrc) {
+    // Reported until the controller's next update replaces it
+    float nominal = ma_atomic_load_explicit_f32(&pDrc->pending.base_ratio, ma_atomic_memory_order_relaxed) * ma_atomic_load_explicit_f32(&pDrc->pending.speed, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_f32(&pDrc->ratio, nominal, ma_atomic_memory_order_relaxed);
+    ma_atomic_fetch_add_explicit_32(&pDrc->generation, 1, ma_atomic_memory_order_release);
+}
+
+/* Controller thread: take newly published parameters and forget the measured history. */
+static void ma_bridge_drc_adopt(ma_bridge_drc* pDrc) {
+    ma_uint32 generation = ma_atomic_load_explicit_32(&pDrc->generation, ma_atomic_memory_order_acquire);
+    if (generation == pDrc->applied_generation) return;
+    pDrc->applied_generation = generation;
+
+    pDrc->params.base_ratio = ma_atomic_load_explicit_f32(&pDrc->pending.base_ratio, ma_atomic_memory_order_relaxed);
+    pDrc->params.speed = ma_atomic_load_explicit_f32(&pDrc->pending.speed, ma_atomic_memory_order_relaxed);
+    pDrc->params.target_frames = ma_atomic_load_explicit_32(&pDrc->pending.target_frames, ma_atomic_memory_order_relaxed);
+    pDrc->params.max_skew = ma_atomic_load_explicit_f32(&pDrc->pending.max_skew, ma_atomic_memory_order_relaxed);
+    pDrc->integral = 0;
+    pDrc->primed = MA_FALSE;
+}
+
+static MA_INLINE float ma_bridge_drc_clamp(float value, float limit) {
+    return value < -limit ? -limit : (value > limit ? limit : value);
+}
+
+/* Returns the ratio to use for the next block, given the current fill. */
+static float ma_bridge_drc_update(ma_bridge_drc* pDrc, ma_uint32 fill_frames, ma_uint32 capacity_frames) {
+    ma_bridge_drc_adopt(pDrc);
+
+    const ma_bridge_drc_params* pParams = &pDrc->params;
+    float nominal = pParams->base_ratio * pParams->speed;
+    float target = pParams->target_frames > 0 ? (float)pParams->target_frames : (float)capacity_frames * 0.5f;
+    if (pParams->max_skew <= 0 || target <= 0) {
+        ma_atomic_store_explicit_f32(&pDrc->ratio, nominal, ma_atomic_memory_order_relaxed);
+        return nominal;
+    }
+
+    if (!pDrc->primed) {
+        pDrc->fill_smoothed = (float)fill_frames;
+        pDrc->primed = MA_TRUE;
+    } else {
+        pDrc->fill_smoothed += MA_BRIDGE_DRC_SMOOTHING * ((float)fill_frames - pDrc->fill_smoothed);
+    }
+
+    // > 0 when too full: consume input faster (higher in/out ratio)
+    float error = ma_bridge_drc_clamp((pDrc->fill_smoothed - target) / target, 1.0f);
+    float kp = pParams->max_skew; // Full-scale error maps to the skew limit
+    pDrc->integral = ma_bridge_drc_clamp(pDrc->integral + kp * MA_BRIDGE_DRC_KI_PER_KP * error, pParams->max_skew); // Anti-windup
+    float correction = ma_bridge_drc_clamp(kp * error + pDrc->integral, pParams->max_skew);
+
+    float ratio = nominal * (1.0f + correction);
+    ma_atomic_store_explicit_f32(&pDrc->ratio, ratio, ma_atomic_memory_order_relaxed);
+    return ratio;
+}
+
+/*
+ * ma_resampler_set_rate_ratio() quantizes to 1/1000, coarser than the
+ * corrections above; go through set_rate with a finer denominator instead.
+ * 65536 (~15 ppm) is the largest that keeps the linear resampler's 32-bit
+ * timer rescale (frac * newRateOut) from overflowing on a rate change.
+ */
+#define MA_BRIDGE_RATIO_DENOMINATOR 65536u
+
+/* Pull-side resampling works in chunks so its scratch buffers stay fixed-size */
+#define MA_BRIDGE_PULL_CHUNK_FRAMES 512
+#define MA_BRIDGE_PULL_INPUT_FRAMES 4096 /* Chunk input for ratios up to ~8x */
+#define MA_BRIDGE_RESAMPLE_CHUNK_FRAMES 1024 /* Write path: output frames per resampler call and publish */
+
+static void ma_bridge_resampler_apply_ratio(ma_resampler* pResampler, float ratio) {
+    ma_uint32 n = (ma_uint32)(ratio * (float)MA_BRIDGE_RATIO_DENOMINATOR + 0.5f);
+    if (n > 0) ma_resampler_set_rate(pResampler, n, MA_BRIDGE_RATIO_DENOMINATOR);
+}
+
+
+#if defined(_MSC_VER)
+#define MA_BRIDGE_CACHE_ALIGNED __declspec(align(MA_BRIDGE_CACHE_LINE_SIZE))
+#else
+#define MA_BRIDGE_CACHE_ALIGNED __attribute__((aligned(MA_BRIDGE_CACHE_LINE_SIZE)))
+#endif
+
+/* Stream: one device with its own FIFOs (playback and/or capture) and producer-side resampler */
+struct ma_bridge_stream {
+    ma_device device;
+    int device_initialized;
+    int device_started;
+
+    /* Optional native producer rendering straight into the device buffer */
+    ma_bridge_render_proc render_proc;
+    ma_bridge_duplex_proc duplex_proc; /* Duplex streams: sees this period's input too */
+    void* render_user_data; /* Passed to whichever of the two is set */
+
+    /* FIFO */
+    ma_bridge_ring ring;
+    int channels; /* Synced with device config */
+    ma_format format; /* FIFO sample format */
+    ma_format device_format; /* What the callback writes; converted from `format` if different */
+
+    ma_uint32 sample_rate; /* Device rate, for period-based trace metrics */
+
+    /* Telemetry, mapped directly by Dart */
+    MA_BRIDGE_CACHE_ALIGNED ma_bridge_stream_stats stats;
+    ma_uint32 trace_enabled;
+    ma_bridge_trace trace;
+
+    /* Playback clock of the latest callback */
+    ma_bridge_clock clock;
+    ma_uint32 output_latency_frames;
+
+    /* Capture FIFO: filled by the callback, drained by the reader */
+    ma_device_type device_type;
+    ma_bridge_ring capture_ring;
+    ma_format capture_device_format; /* What the callback receives; converted into `format` */
+    MA_BRIDGE_CACHE_ALIGNED ma_bridge_stream_stats capture_stats;
+    ma_bridge_clock capture_clock;
+    ma_uint32 input_latency_frames;
+
+    /* Producers blocked in ma_bridge_stream_wait_* */
+    ma_bridge_waiter waiter;
+
+    /* Low-water events posted to a Dart port */
+    ma_bridge_notifier notifier;
+
+    /* Resampler */
+    ma_resampler resampler;
+    int resampler_initialized;
+    ma_uint32 resampler_rate_in;
+    ma_uint32 resampler_rate_out;
+    ma_bridge_drc drc;
+    ma_bridge_resample_quality resample_quality; /* Applied at the next resampler init */
+
+    /* Pull-side resampler (source-rate FIFO, resampled in the callback) */
+    int pull_resampling;
+    ma_resampler pull_resampler;
+    float* pull_in;            /* MA_BRIDGE_PULL_INPUT_FRAMES, carried between chunks */
+    ma_uint32 pull_in_frames;
+    float* pull_out;           /* MA_BRIDGE_PULL_CHUNK_FRAMES, when the device is not f32 */
+
+    /* Offline streams: pumped on a virtual clock instead of by a device */
+    ma_bridge_offline offline;
+};
+
+/* A device or an offline pump backs the stream */
+static MA_INLINE ma_bool32 ma_bridge_stream_is_open(const ma_bridge_stream* pStream) {
+    return pStream->device_initialized || pStream->offline.enabled;
+}
+
+/* --- Stream Telemetry --- */
+
+/* The producer's counters start the second cache line of the stats block */
+typedef char ma_bridge_stats_layout_check[(offsetof(ma_bridge_stream_stats, overrun_events) == MA_BRIDGE_CACHE_LINE_SIZE && sizeof(ma_bridge_stream_stats) == 2 * MA_BRIDGE_CACHE_LINE_SIZE) ? 1 : -1];
+
+static void ma_bridge_stats_init(ma_bridge_stream_stats* pStats) {
+    memset(pStats, 0, sizeof(*pStats));
+    pStats->version = MA_BRIDGE_STREAM_STATS_VERSION;
+    pStats->size = (uint32_t)sizeof(*pStats);
+    pStats->reset_requested = 1; /* First callback seeds min/max fill */
+}
+
+/* Audio thread only. Seqlock-protected so readers never see a torn 64-bit value. */
+/* frames_read: FIFO frames consumed; frames_delivered: device frames with audio (differ when resampling in the callback) */
+static void ma_bridge_stats_record_callback(ma_bridge_stream_stats* pStats, ma_uint32 frameCount, ma_uint32 fill_frames, ma_uint32 frames_read, ma_uint32 frames_delivered) {
+    ma_uint32 seq = pStats->sequence;
+    ma_atomic_store_explicit_32(&pStats->sequence, seq + 1, ma_atomic_memory_order_relaxed);
+    ma_atomic_thread_fence(ma_atomic_memory_order_release);
+
+    ma_uint64 fill_min = pStats->fill_min_frames;
+    ma_uint64 fill_max = pStats->fill_max_frames;
+    if (ma_atomic_exchange_explicit_32(&pStats->reset_requested, 0, ma_atomic_memory_order_acquire)) {
+        fill_min = fill_max = fill_frames;
+    } else {
+        if (fill_frames < fill_min) fill_min = fill_frames;
+        if (fill_frames > fill_max) fill_max = fill_frames;
+    }
+    ma_atomic_store_explicit_64(&pStats->fill_min_frames, fill_min, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_64(&pStats->fill_max_frames, fill_max, ma_atomic_memory_order_relaxed);
+
+    ma_atomic_store_explicit_64(&pStats->frames_consumed, pStats->frames_consumed + frames_read, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_64(&pStats->callback_count, pStats->callback_count + 1, ma_atomic_memory_order_relaxed);
+    if (frames_delivered < frameCount) {
+        ma_atomic_store_explicit_64(&pStats->underrun_events, pStats->underrun_events + 1, ma_atomic_memory_order_relaxed);
+        ma_atomic_store_explicit_64(&pStats->underrun_frames, pStats->underrun_frames + (frameCount - frames_delivered), ma_atomic_memory_order_relaxed);
+    }
 
-// Wrapper for printf to handle switch safely
-#define MA_LOG(...) if (g_log_enabled) { printf(__VA_ARGS__); }
+    ma_atomic_store_explicit_32(&pStats->sequence, seq + 2, ma_atomic_memory_order_release);
+}
+
+/* Producer thread only. */
+static void ma_bridge_stats_record_overrun(ma_bridge_stream_stats* pStats, ma_uint32 requested, ma_uint32 accepted) {
+    if (accepted >= requested) return;
+    ma_atomic_store_explicit_64(&pStats->overrun_events, pStats->overrun_events + 1, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_64(&pStats->overrun_frames, pStats->overrun_frames + (requested - accepted), ma_atomic_memory_order_relaxed);
+}
+
+/* Default stream behind the legacy ma_bridge_* device calls */
+static ma_bridge_stream g_stream = { .channels = 2, .format = ma_format_s16, .device_format = ma_format_s16 };
+
+
+/* --- Backend Selection --- */
+
+#define MA_BRIDGE_BACKEND_COUNT (ma_backend_null + 1)
+
+/* Probe order for the context; empty = every compiled-in backend in miniaudio's order */
+static ma_backend g_backends[MA_BRIDGE_BACKEND_COUNT];
+static ma_uint32 g_backend_count = 0;
+
+/* What the context init tried, in order (the last entry is the one in use on success) */
+static ma_bridge_backend_probe g_backend_probes[MA_BRIDGE_BACKEND_COUNT];
+static ma_uint32 g_backend_probe_count = 0;
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_set_backends(const int32_t* backends, int32_t count) {
+    if (g_context_initialized) return -1; // Only the first init probes
+    if (!backends || count <= 0) {
+        g_backend_count = 0;
+        return 0;
+    }
+
+    ma_uint32 kept = 0;
+    for (int32_t i = 0; i < count && kept < MA_BRIDGE_BACKEND_COUNT; i++) {
+        if (backends[i] < 0 || backends[i] >= MA_BRIDGE_BACKEND_COUNT) continue;
+        ma_backend backend = (ma_backend)backends[i];
+        if (!ma_is_backend_enabled(backend)) continue; // Compiled out or not on this platform
+
+        ma_bool32 duplicate = MA_FALSE;
+        for (ma_uint32 j = 0; j < kept; j++) {
+            if (g_backends[j] == backend) duplicate = MA_TRUE;
+        }
+        if (!duplicate) g_backends[kept++] = backend;
+    }
+    g_backend_count = kept;
+    return (int32_t)kept;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_backend_probes(ma_bridge_backend_probe* probes, int32_t capacity) {
+    if (probes && capacity > 0) {
+        ma_uint32 n = ((ma_uint32)capacity < g_backend_probe_count) ? (ma_uint32)capacity : g_backend_probe_count;
+        memcpy(probes, g_backend_probes, sizeof(ma_bridge_backend_probe) * n);
+    }
+    return (int32_t)g_backend_probe_count;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_backend(void) {
+    return g_context_initialized ? (int32_t)g_context.backend : -1;
+}
+
+MA_BRIDGE_EXPORT const char* ma_bridge_get_backend_name(int32_t backend) {
+    if (backend < 0 || backend >= MA_BRIDGE_BACKEND_COUNT) return "Unknown";
+    return ma_get_backend_name((ma_backend)backend);
+}
+
+/* --- Internal Helpers --- */
 
 static ma_result EnsureContextInit(void) {
+    ma_bridge_log_start();
     if (g_context_initialized) return MA_SUCCESS;
-    
-    ma_result result = ma_context_init(NULL, 0, NULL, &g_context);
+
+    ma_backend order[MA_BRIDGE_BACKEND_COUNT];
+    size_t order_count = 0;
+    if (g_backend_count > 0) {
+        memcpy(order, g_backends, sizeof(ma_backend) * g_backend_count);
+        order_count = g_backend_count;
+    } else {
+        ma_get_enabled_backends(order, MA_BRIDGE_BACKEND_COUNT, &order_count);
+    }
+
+    // One backend per attempt (what ma_context_init does internally) so each probe can be timed
+    ma_result result = MA_NO_BACKEND;
+    g_backend_probe_count = 0;
+    for (size_t i = 0; i < order_count; i++) {
+        uint64_t start_ns = ma_bridge_now_ns();
+        result = ma_context_init(&order[i], 1, NULL, &g_context);
+
+        ma_bridge_backend_probe* pProbe = &g_backend_probes[g_backend_probe_count++];
+        pProbe->backend = (int32_t)order[i];
+        pProbe->result = (int32_t)result;
+        pProbe->elapsed_ns = ma_bridge_now_ns() - start_ns;
+        MA_BRIDGE_LOG(ma_bridge_log_level_info, "Backend %s: %s in %.2f ms", ma_get_backend_name(order[i]),
+            (result == MA_SUCCESS) ? "ok" : ma_result_description(result), pProbe->elapsed_ns / 1e6);
+        if (result == MA_SUCCESS) break;
+    }
+
     if (result == MA_SUCCESS) {
         g_context_initialized = 1;
-        printf("[miniaudio_bridge] Context initialized\n");
+        MA_BRIDGE_LOG(ma_bridge_log_level_info, "Context initialized");
     } else {
-        printf("[miniaudio_bridge] Failed to init context: %d\n", result);
+        MA_BRIDGE_LOG(ma_bridge_log_level_error, "Failed to init context: %d", result);
     }
     return result;
 }
 
+/* --- Device Options --- */
+
+static ma_bridge_device_config g_device_config;
+static int g_device_config_set = 0;
+
+MA_BRIDGE_EXPORT void ma_bridge_device_config_init(ma_bridge_device_config* config) {
+    if (!config) return;
+    memset(config, 0, sizeof(*config));
+    config->no_pre_silenced_output_buffer = 1; // Every callback path writes all of pOutput
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_set_device_config(const ma_bridge_device_config* config) {
+    if (config) {
+        g_device_config = *config;
+        g_device_config_set = 1;
+    } else {
+        g_device_config_set = 0;
+    }
+}
+
+static void ma_bridge_apply_device_config(ma_device_config* pConfig) {
+    ma_bridge_device_config options;
+    if (g_device_config_set) {
+        options = g_device_config;
+    } else {
+        ma_bridge_device_config_init(&options);
+    }
+
+    if (options.periods > 0) pConfig->periods = (ma_uint32)options.periods;
+    pConfig->performanceProfile = options.conservative ? ma_performance_profile_conservative : ma_performance_profile_low_latency;
+    pConfig->noPreSilencedOutputBuffer = options.no_pre_silenced_output_buffer ? MA_TRUE : MA_FALSE;
+    pConfig->noClip = options.no_clip ? MA_TRUE : MA_FALSE;
+    pConfig->noFixedSizedCallback = options.no_fixed_sized_callback ? MA_TRUE : MA_FALSE;
+    pConfig->noDisableDenormals = options.no_disable_denormals ? MA_TRUE : MA_FALSE;
+    if (options.exclusive) {
+        pConfig->playback.shareMode = ma_share_mode_exclusive;
+        pConfig->capture.shareMode = ma_share_mode_exclusive;
+    }
+    pConfig->alsa.noMMap = options.alsa_no_mmap ? MA_TRUE : MA_FALSE;
+    pConfig->alsa.noAutoFormat = options.alsa_no_auto_format ? MA_TRUE : MA_FALSE;
+    pConfig->alsa.noAutoChannels = options.alsa_no_auto_channels ? MA_TRUE : MA_FALSE;
+    pConfig->alsa.noAutoResample = options.alsa_no_auto_resample ? MA_TRUE : MA_FALSE;
+    pConfig->aaudio.allowSetBufferCapacity = options.aaudio_allow_set_buffer_capacity ? MA_TRUE : MA_FALSE;
+}
+
 /* --- Context / Enumeration API --- */
 
-MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_device_count(int32_t type) {
-    if (EnsureContextInit() != MA_SUCCESS) return 0;
-    
+/*
+ * Device snapshot per direction. Enumerating (and probing native formats)
+ * can take hundreds of ms on ALSA/PulseAudio, so it is done once and every
+ * enumeration call reads the cached copy until it is invalidated.
+ */
+typedef struct {
+    int valid;
+    ma_uint32 count;
+    ma_bridge_device_record* records;
+} ma_bridge_device_snapshot;
+
+static ma_bridge_device_snapshot g_device_snapshots[2]; // Playback, capture
+
+typedef char ma_bridge_device_id_fits[(sizeof(ma_device_id) <= MA_BRIDGE_DEVICE_ID_LEN) ? 1 : -1];
+
+static void ma_bridge_device_record_init(ma_bridge_device_record* pRecord, ma_device_type device_type, const ma_device_info* pInfo) {
+    memset(pRecord, 0, sizeof(*pRecord));
+    ma_strncpy_s(pRecord->name, sizeof(pRecord->name), pInfo->name, (size_t)-1); // Truncates
+    memcpy(pRecord->id, &pInfo->id, sizeof(ma_device_id));
+    pRecord->is_default = pInfo->isDefault ? 1 : 0;
+
+    // The list from ma_context_get_devices carries no formats on most backends
+    ma_device_info detail;
+    const ma_device_info* pFormats = pInfo;
+    if (ma_context_get_device_info(&g_context, device_type, &pInfo->id, &detail) == MA_SUCCESS) {
+        pFormats = &detail;
+        if (detail.isDefault) pRecord->is_default = 1;
+    }
+
+    ma_uint32 count = pFormats->nativeDataFormatCount;
+    if (count > MA_BRIDGE_DEVICE_MAX_FORMATS) count = MA_BRIDGE_DEVICE_MAX_FORMATS;
+    for (ma_uint32 i = 0; i < count; i++) {
+        pRecord->formats[i].format = (int32_t)pFormats->nativeDataFormats[i].format;
+        pRecord->formats[i].channels = (int32_t)pFormats->nativeDataFormats[i].channels;
+        pRecord->formats[i].sample_rate = (int32_t)pFormats->nativeDataFormats[i].sampleRate;
+        pRecord->formats[i].flags = (int32_t)pFormats->nativeDataFormats[i].flags;
+    }
+    pRecord->format_count = (int32_t)count;
+}
+
+static ma_bridge_device_snapshot* ma_bridge_get_device_snapshot(int32_t type) {
+    ma_bridge_device_snapshot* pSnapshot = &g_device_snapshots[type == 0 ? 0 : 1];
+    if (pSnapshot->valid) return pSnapshot;
+    if (EnsureContextInit() != MA_SUCCESS) return NULL;
+
     ma_device_info* pPlaybackInfos;
     ma_uint32 playbackCount;
     ma_device_info* pCaptureInfos;
     ma_uint32 captureCount;
-    
+
     if (ma_context_get_devices(&g_context, &pPlaybackInfos, &playbackCount, &pCaptureInfos, &captureCount) != MA_SUCCESS) {
-        return 0;
+        return NULL;
     }
-    
-    return (type == 0) ? (int32_t)playbackCount : (int32_t)captureCount;
+
+    ma_device_type device_type = (type == 0) ? ma_device_type_playback : ma_device_type_capture;
+    ma_uint32 count = (type == 0) ? playbackCount : captureCount;
+    ma_bridge_device_record* pRecords = NULL;
+    if (count > 0) {
+        // The context's arrays are only valid until its next enumeration, so copy them first
+        ma_device_info* pInfos = (ma_device_info*)malloc(sizeof(ma_device_info) * count);
+        pRecords = (ma_bridge_device_record*)malloc(sizeof(ma_bridge_device_record) * count);
+        if (!pInfos || !pRecords) {
+            free(pInfos);
+            free(pRecords);
+            return NULL;
+        }
+        memcpy(pInfos, (type == 0) ? pPlaybackInfos : pCaptureInfos, sizeof(ma_device_info) * count);
+        for (ma_uint32 i = 0; i < count; i++) {
+            ma_bridge_device_record_init(&pRecords[i], device_type, &pInfos[i]);
+        }
+        free(pInfos);
+    }
+
+    free(pSnapshot->records);
+    pSnapshot->records = pRecords;
+    pSnapshot->count = count;
+    pSnapshot->valid = 1;
+    return pSnapshot;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_devices(int32_t type, ma_bridge_device_record* records, int32_t capacity) {
+    ma_bridge_device_snapshot* pSnapshot = ma_bridge_get_device_snapshot(type);
+    if (!pSnapshot) return -1;
+
+    if (records && capacity > 0) {
+        ma_uint32 n = ((ma_uint32)capacity < pSnapshot->count) ? (ma_uint32)capacity : pSnapshot->count;
+        if (n > 0) memcpy(records, pSnapshot->records, sizeof(ma_bridge_device_record) * n);
+    }
+    return (int32_t)pSnapshot->count;
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_context_invalidate_devices(void) {
+    g_device_snapshots[0].valid = 0;
+    g_device_snapshots[1].valid = 0;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_device_count(int32_t type) {
+    ma_bridge_device_snapshot* pSnapshot = ma_bridge_get_device_snapshot(type);
+    return pSnapshot ? (int32_t)pSnapshot->count : 0;
 }
 
 MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_device_info(int32_t type, int32_t index, char* name_buffer, int32_t name_len, void* id_buffer, int32_t id_len) {
-    if (EnsureContextInit() != MA_SUCCESS) return -1;
+    ma_bridge_device_snapshot* pSnapshot = ma_bridge_get_device_snapshot(type);
+    if (!pSnapshot || index < 0 || (ma_uint32)index >= pSnapshot->count) return -1;
+
+    const ma_bridge_device_record* pRecord = &pSnapshot->records[index];
+
+    /* Copy Name */
+    if (name_buffer && name_len > 0) {
+        strncpy(name_buffer, pRecord->name, name_len - 1);
+        name_buffer[name_len - 1] = '\0';
+    }
+
+    /* Copy ID */
+    if (id_buffer && id_len >= (int32_t)sizeof(ma_device_id)) {
+        memcpy(id_buffer, pRecord->id, sizeof(ma_device_id));
+    }
+    return 0;
+}
+
+
+/* --- Device API (Low Level Stream) --- */
+
+/*
+ * Pull-side resampling: the FIFO holds source-rate audio and the callback
+ * resamples it (in f32) straight into the device buffer, re-steering the
+ * ratio every period from the fill it sees. Input left over by the resampler
+ * is carried to the next chunk, so nothing read from the ring is lost.
+ */
+static ma_uint32 ma_bridge_stream_process_pull(ma_bridge_stream* pStream, void* pOutput, ma_uint32 frameCount, ma_uint32 rendered) {
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 capacity_frames = pStream->ring.capacity / channels;
+    ma_uint32 fill_frames = ma_bridge_ring_fill(&pStream->ring) / channels;
+    ma_uint32 fill_start = fill_frames;
+    ma_uint32 consumed = 0;
+    ma_uint32 produced = 0;
+
+    ma_bridge_resampler_apply_ratio(&pStream->pull_resampler, ma_bridge_drc_update(&pStream->drc, fill_frames + pStream->pull_in_frames, capacity_frames));
+
+    while (produced < frameCount) {
+        ma_uint32 chunk = frameCount - produced;
+        if (chunk > MA_BRIDGE_PULL_CHUNK_FRAMES) chunk = MA_BRIDGE_PULL_CHUNK_FRAMES;
+
+        // Top the carried input up to what this chunk needs
+        ma_uint64 needed = 0;
+        ma_resampler_get_required_input_frame_count(&pStream->pull_resampler, chunk, &needed);
+        if (needed > MA_BRIDGE_PULL_INPUT_FRAMES) needed = MA_BRIDGE_PULL_INPUT_FRAMES;
+        if (needed > pStream->pull_in_frames && fill_frames > 0) {
+            ma_uint32 take = (ma_uint32)needed - pStream->pull_in_frames;
+            if (take > fill_frames) take = fill_frames;
+            ma_bridge_ring_read(&pStream->ring, pStream->pull_in + (size_t)pStream->pull_in_frames * channels, ma_format_f32, take * channels);
+            pStream->pull_in_frames += take;
+            fill_frames -= take;
+            consumed += take;
+        }
+
+        void* pDst = (pStream->device_format == ma_format_f32) ? ma_offset_pcm_frames_ptr(pOutput, produced, ma_format_f32, channels) : (void*)pStream->pull_out;
+        ma_uint64 frames_in = pStream->pull_in_frames;
+        ma_uint64 frames_out = chunk;
+        ma_resampler_process_pcm_frames(&pStream->pull_resampler, pStream->pull_in, &frames_in, pDst, &frames_out);
+
+        pStream->pull_in_frames -= (ma_uint32)frames_in;
+        if (pStream->pull_in_frames > 0 && frames_in > 0) {
+            MA_MOVE_MEMORY(pStream->pull_in, pStream->pull_in + (size_t)frames_in * channels, (size_t)pStream->pull_in_frames * channels * sizeof(float));
+        }
+        if (pDst == (void*)pStream->pull_out) {
+            ma_bridge_pcm_convert(ma_offset_pcm_frames_ptr(pOutput, produced, pStream->device_format, channels), pStream->device_format, pStream->pull_out, ma_format_f32, (ma_uint32)frames_out * channels);
+        }
+        produced += (ma_uint32)frames_out;
+        if (frames_out < chunk) break; // Starved
+    }
+
+    if (produced < frameCount) {
+        ma_silence_pcm_frames(ma_offset_pcm_frames_ptr(pOutput, produced, pStream->device_format, channels), frameCount - produced, pStream->device_format, channels);
+    }
+
+    ma_bridge_stats_record_callback(&pStream->stats, rendered + frameCount, fill_start, rendered + consumed, rendered + produced);
+    ma_bridge_waiter_signal(&pStream->waiter);
+    return produced;
+}
+
+/*
+ * Render one period from the stream's FIFO. Split out of data_callback so the
+ * stream path can be driven without a device. pInput is this period's capture
+ * buffer on duplex streams, NULL otherwise.
+ */
+static ma_uint32 ma_bridge_stream_process(ma_bridge_stream* pStream, const void* pInput, void* pOutput, ma_uint32 frameCount) {
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 rendered = 0;
+    int has_proc = (pStream->render_proc != NULL || pStream->duplex_proc != NULL);
+
+    // Native producer renders in place; the FIFO only covers what it could not
+    if (has_proc) {
+        int32_t result = 0;
+        if (pStream->duplex_proc) {
+            if (pInput) result = pStream->duplex_proc(pStream->render_user_data, pInput, pOutput, (int32_t)frameCount);
+        } else {
+            result = pStream->render_proc(pStream->render_user_data, pOutput, (int32_t)frameCount);
+        }
+        rendered = (result <= 0) ? 0 : ((ma_uint32)result < frameCount ? (ma_uint32)result : frameCount);
+    }
+    void* pRemaining = ma_offset_pcm_frames_ptr(pOutput, rendered, pStream->device_format, channels);
+    ma_uint32 remaining = frameCount - rendered;
+
+    if (!ma_bridge_ring_is_valid(&pStream->ring)) {
+        ma_silence_pcm_frames(pRemaining, remaining, pStream->device_format, channels);
+        if (!has_proc) return 0; // No FIFO attached yet: not an underrun
+        ma_bridge_stats_record_callback(&pStream->stats, frameCount, 0, rendered, rendered);
+        return rendered;
+    }
+
+    if (pStream->pull_resampling) {
+        return rendered + ma_bridge_stream_process_pull(pStream, pRemaining, remaining, rendered);
+    }
     
-    ma_device_info* pPlaybackInfos;
-    ma_uint32 playbackCount;
-    ma_device_info* pCaptureInfos;
-    ma_uint32 captureCount;
+    // Only whole frames are taken; the ring drains (and converts) in at most two contiguous passes
+    ma_uint32 frames_available = ma_bridge_ring_fill(&pStream->ring) / channels;
+    ma_uint32 frames_to_read = (frames_available < remaining) ? frames_available : remaining;
+    ma_bridge_ring_read(&pStream->ring, pRemaining, pStream->device_format, frames_to_read * channels);
     
-    if (ma_context_get_devices(&g_context, &pPlaybackInfos, &playbackCount, &pCaptureInfos, &captureCount) != MA_SUCCESS) {
-        return -1;
+    if (frames_to_read < remaining) {
+        ma_silence_pcm_frames(ma_offset_pcm_frames_ptr(pRemaining, frames_to_read, pStream->device_format, channels), remaining - frames_to_read, pStream->device_format, channels);
     }
     
-    ma_device_info* pInfo = NULL;
-    if (type == 0) { // Playback
-        if (index >= 0 && index < (int32_t)playbackCount) pInfo = &pPlaybackInfos[index];
-    } else { // Capture
-        if (index >= 0 && index < (int32_t)captureCount) pInfo = &pCaptureInfos[index];
+    ma_bridge_stats_record_callback(&pStream->stats, frameCount, frames_available, rendered + frames_to_read, rendered + frames_to_read);
+    ma_bridge_waiter_signal(&pStream->waiter);
+    return rendered + frames_to_read;
+}
+
+/*
+ * Capture side of a period: the callback is the producer of the capture FIFO.
+ * Frames that do not fit (the reader fell behind) are dropped and counted as
+ * overruns; the callback never waits.
+ */
+static ma_uint32 ma_bridge_stream_process_capture(ma_bridge_stream* pStream, const void* pInput, ma_uint32 frameCount) {
+    if (!ma_bridge_ring_is_valid(&pStream->capture_ring)) return 0; // No FIFO attached yet: not an overrun
+
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 fill_frames = ma_bridge_ring_fill(&pStream->capture_ring) / channels;
+    ma_uint32 free_frames = pStream->capture_ring.capacity / channels - fill_frames;
+    ma_uint32 frames_to_write = (free_frames < frameCount) ? free_frames : frameCount;
+
+    ma_bridge_ring_write_from(&pStream->capture_ring, pInput, pStream->capture_device_format, frames_to_write * channels);
+
+    ma_bridge_stats_record_callback(&pStream->capture_stats, frameCount, fill_frames, frames_to_write, frameCount);
+    ma_bridge_stats_record_overrun(&pStream->capture_stats, frameCount, frames_to_write);
+    ma_bridge_waiter_signal(&pStream->waiter);
+    return frames_to_write;
+}
+
+/*
+ * One callback period. start_ns is the host time of the period (virtual on
+ * offline streams); the trace adds the real time spent processing to it.
+ */
+static ma_uint32 ma_bridge_stream_run_period(ma_bridge_stream* pStream, void* pOutput, const void* pInput, ma_uint32 frameCount, ma_uint64 start_ns) {
+    ma_uint64 real_start_ns = ma_bridge_now_ns();
+    ma_uint32 delivered = 0;
+    MA_BRIDGE_RT_ENTER("data_callback");
+
+    // Publish (position, time) for the first frame of this buffer. On duplex
+    // devices both buffers cover the same period: input is stored first, so a
+    // reader woken here and the duplex callback below see the same frames.
+    if (pInput) {
+        ma_bridge_clock_publish(&pStream->capture_clock, pStream->capture_stats.frames_consumed, start_ns);
+        delivered = ma_bridge_stream_process_capture(pStream, pInput, frameCount);
     }
-    
-    if (pInfo) {
-        /* Copy Name */
-        if (name_buffer && name_len > 0) {
-            strncpy(name_buffer, pInfo->name, name_len - 1);
-            name_buffer[name_len - 1] = '\0';
+
+    if (pOutput) {
+        ma_bridge_clock_publish(&pStream->clock, pStream->stats.frames_consumed, start_ns);
+        delivered = ma_bridge_stream_process(pStream, pInput, pOutput, frameCount);
+
+        if (ma_bridge_ring_is_valid(&pStream->ring)) {
+            ma_bridge_notifier_update(&pStream->notifier, ma_bridge_ring_fill(&pStream->ring) / pStream->channels);
         }
-        
-        /* Copy ID */
-        if (id_buffer && id_len >= sizeof(ma_device_id)) {
-            memcpy(id_buffer, &pInfo->id, sizeof(ma_device_id));
+    }
+
+    if (ma_atomic_load_explicit_32(&pStream->trace_enabled, ma_atomic_memory_order_relaxed)) {
+        ma_bridge_trace_push(&pStream->trace, start_ns, start_ns + (ma_bridge_now_ns() - real_start_ns), frameCount, delivered);
+    }
+    MA_BRIDGE_RT_LEAVE();
+    return delivered;
+}
+
+static void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
+    ma_bridge_stream* pStream = (ma_bridge_stream*)pDevice->pUserData;
+    ma_bridge_stream_run_period(pStream, pOutput, pInput, frameCount, ma_bridge_now_ns());
+}
+
+/* Run the next offline period into pOutput (one period in the device format). */
+static ma_uint32 ma_bridge_offline_step(ma_bridge_stream* pStream, void* pOutput, ma_uint64 start_ns) {
+    ma_bridge_offline* pOffline = &pStream->offline;
+    ma_uint32 delivered = ma_bridge_stream_run_period(pStream, pOutput, NULL, pOffline->period_frames, start_ns);
+    pOffline->frames += pOffline->period_frames;
+    return delivered;
+}
+
+static ma_thread_result MA_THREADCALL ma_bridge_offline_thread(void* pData) {
+    ma_bridge_stream* pStream = (ma_bridge_stream*)pData;
+    ma_bridge_offline* pOffline = &pStream->offline;
+    ma_bridge_waiter* pWaiter = &pOffline->waiter;
+    ma_uint64 real_origin_ns = ma_bridge_now_ns();
+    ma_uint64 virtual_origin_ns = ma_bridge_offline_now_ns(pOffline, pStream->sample_rate);
+
+    ma_atomic_fetch_add_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    while (ma_atomic_load_explicit_32(&pOffline->running, ma_atomic_memory_order_acquire)) {
+        ma_uint64 start_ns = ma_bridge_offline_period_start_ns(pOffline, pStream->sample_rate);
+
+        // Paced: wake when real time catches up with the (jittered) virtual time
+        if (pOffline->speed > 0) {
+            ma_uint64 virtual_elapsed_ns = (start_ns > virtual_origin_ns) ? start_ns - virtual_origin_ns : 0;
+            ma_uint64 due_ns = real_origin_ns + (ma_uint64)((double)virtual_elapsed_ns / pOffline->speed);
+            for (;;) {
+                ma_uint32 seen = ma_atomic_load_explicit_32(&pWaiter->sequence, ma_atomic_memory_order_seq_cst);
+                ma_uint64 now_ns = ma_bridge_now_ns();
+                if (now_ns >= due_ns || !ma_atomic_load_explicit_32(&pOffline->running, ma_atomic_memory_order_acquire)) break;
+                ma_bridge_waiter_sleep(pWaiter, seen, due_ns - now_ns);
+            }
+            if (!ma_atomic_load_explicit_32(&pOffline->running, ma_atomic_memory_order_acquire)) break;
         }
-        return 0;
+        ma_bridge_offline_step(pStream, pOffline->output, start_ns);
+    }
+    ma_atomic_fetch_sub_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    return (ma_thread_result)0;
+}
+
+static int ma_bridge_offline_start(ma_bridge_stream* pStream) {
+    ma_bridge_offline* pOffline = &pStream->offline;
+    if (pOffline->thread_started) return 0;
+
+    pOffline->running = 1;
+    if (ma_thread_create(&pOffline->thread, ma_thread_priority_default, 0, ma_bridge_offline_thread, pStream, NULL) != MA_SUCCESS) {
+        pOffline->running = 0;
+        return -1;
+    }
+    pOffline->thread_started = MA_TRUE;
+    return 0;
+}
+
+static void ma_bridge_offline_stop(ma_bridge_stream* pStream) {
+    ma_bridge_offline* pOffline = &pStream->offline;
+    if (!pOffline->thread_started) return;
+
+    ma_atomic_store_explicit_32(&pOffline->running, 0, ma_atomic_memory_order_release);
+    ma_bridge_waiter_signal(&pOffline->waiter);
+    ma_thread_wait(&pOffline->thread);
+    pOffline->thread_started = MA_FALSE;
+}
+
+static void ma_bridge_stream_uninit_pull_resampler(ma_bridge_stream* pStream) {
+    if (pStream->pull_resampling) {
+        ma_resampler_uninit(&pStream->pull_resampler, NULL);
+        pStream->pull_resampling = 0;
+    }
+    free(pStream->pull_in);
+    free(pStream->pull_out);
+    pStream->pull_in = NULL;
+    pStream->pull_out = NULL;
+    pStream->pull_in_frames = 0;
+}
+
+/* Backend buffer of one side of the device, in device-rate frames */
+static ma_uint32 ma_bridge_device_buffer_frames(ma_uint32 period_frames, ma_uint32 periods, ma_uint32 internal_rate, ma_uint32 device_rate) {
+    ma_uint64 internal_frames = (ma_uint64)period_frames * periods;
+    if (internal_rate > 0 && internal_rate != device_rate) {
+        internal_frames = internal_frames * device_rate / internal_rate;
+    }
+    return (ma_uint32)internal_frames;
+}
+
+/* Stream state shared by device-backed and offline streams */
+static void ma_bridge_stream_init_state(ma_bridge_stream* pStream, ma_device_type device_type, int channels, ma_format format) {
+    pStream->channels = channels;
+    pStream->format = format;
+    pStream->device_type = device_type;
+    ma_bridge_stats_init(&pStream->stats);
+    ma_bridge_stats_init(&pStream->capture_stats);
+    ma_bridge_waiter_init(&pStream->waiter);
+    ma_bridge_drc_init(&pStream->drc);
+    ma_bridge_log_start(); // Offline streams open no context
+    ma_bridge_clock_reset(&pStream->clock);
+    ma_bridge_clock_reset(&pStream->capture_clock);
+    pStream->output_latency_frames = 0;
+    pStream->input_latency_frames = 0;
+}
+
+static int ma_bridge_stream_init_device(ma_bridge_stream* pStream, ma_device_type device_type, void* device_id, void* capture_device_id, int sample_rate, int channels, int buffer_frames, ma_format format, ma_bridge_render_proc render_proc, ma_bridge_duplex_proc duplex_proc, void* render_user_data) {
+    if (ma_bridge_stream_is_open(pStream)) ma_bridge_stream_uninit(pStream); // Re-init this stream only
+    EnsureContextInit(); // Context is shared by all streams
+    
+    ma_bridge_stream_init_state(pStream, device_type, channels, format);
+    pStream->render_proc = render_proc;
+    pStream->duplex_proc = duplex_proc;
+    pStream->render_user_data = render_user_data;
+    
+    ma_device_config config = ma_device_config_init(device_type);
+    // Native device format: the callback converts straight out of the ring, so
+    // miniaudio's own converter and its intermediate buffer are bypassed.
+    // A render callback writes pOutput directly, so it gets the format it asked for.
+    config.playback.format = (render_proc || duplex_proc) ? format : ma_format_unknown;
+    config.playback.channels = channels;
+    config.playback.pDeviceID = (ma_device_id*)device_id; // Can be NULL
+    // Capture mirrors this: the callback converts into the capture ring on the way in.
+    // A duplex callback reads pInput directly, so both sides share its format.
+    config.capture.format = duplex_proc ? format : ma_format_unknown;
+    config.capture.channels = channels;
+    config.capture.pDeviceID = (ma_device_id*)capture_device_id;
+    config.sampleRate = sample_rate;
+    config.dataCallback = data_callback;
+    config.pUserData = pStream;
+    config.periodSizeInFrames = buffer_frames;
+    ma_bridge_apply_device_config(&config);
+    
+    ma_result result = ma_device_init(&g_context, &config, &pStream->device);
+    if (result != MA_SUCCESS) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_error, "Failed to init device: %d", result);
+        return -1;
+    }
+    
+    pStream->sample_rate = pStream->device.sampleRate;
+
+    // Backend buffers are in the internal rate; convert to device-rate frames
+    if (device_type != ma_device_type_capture) {
+        pStream->device_format = pStream->device.playback.format;
+        pStream->output_latency_frames = ma_bridge_device_buffer_frames(pStream->device.playback.internalPeriodSizeInFrames, pStream->device.playback.internalPeriods, pStream->device.playback.internalSampleRate, pStream->sample_rate)
+            + (ma_uint32)ma_data_converter_get_output_latency(&pStream->device.playback.converter);
+    }
+    if (device_type != ma_device_type_playback) {
+        // Captured audio is at least one period old when the callback sees it
+        pStream->capture_device_format = pStream->device.capture.format;
+        pStream->input_latency_frames = ma_bridge_device_buffer_frames(pStream->device.capture.internalPeriodSizeInFrames, 1, pStream->device.capture.internalSampleRate, pStream->sample_rate)
+            + (ma_uint32)ma_data_converter_get_output_latency(&pStream->device.capture.converter);
+    }
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "Device Initialized. Rate: %d, Channels: %d, BufferFrames: %d, Format: %s -> %s", sample_rate, channels, buffer_frames, ma_get_format_name(format),
+        ma_get_format_name(device_type == ma_device_type_capture ? pStream->capture_device_format : pStream->device_format));
+    pStream->device_initialized = 1;
+    return 0;
+}
+
+/* Heap streams are cache-line aligned, for their stats blocks */
+static ma_bridge_stream* ma_bridge_stream_alloc(void) {
+    ma_bridge_stream* pStream = (ma_bridge_stream*)ma_aligned_malloc(sizeof(ma_bridge_stream), MA_BRIDGE_CACHE_LINE_SIZE, NULL);
+    if (pStream) memset(pStream, 0, sizeof(*pStream));
+    return pStream;
+}
+
+/* Also on create failures: the waiters may already hold an OS handle */
+static void ma_bridge_stream_free(ma_bridge_stream* pStream) {
+    ma_bridge_waiter_uninit(&pStream->waiter);
+    ma_bridge_waiter_uninit(&pStream->notifier.waiter);
+    ma_bridge_waiter_uninit(&pStream->offline.waiter);
+    ma_aligned_free(pStream, NULL);
+}
+
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format) {
+    return ma_bridge_stream_create_with_render_callback(device_id, sample_rate, channels, buffer_frames, format, NULL, NULL);
+}
+
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_with_render_callback(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format, ma_bridge_render_proc render, void* user_data) {
+    if (format != ma_bridge_format_s16 && format != ma_bridge_format_s24 && format != ma_bridge_format_s32 && format != ma_bridge_format_f32) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_warning, "Unsupported FIFO format: %d", (int)format);
+        return NULL;
+    }
+
+    ma_bridge_stream* pStream = ma_bridge_stream_alloc();
+    if (!pStream) return NULL;
+
+    if (ma_bridge_stream_init_device(pStream, ma_device_type_playback, device_id, NULL, sample_rate, channels, buffer_frames, (ma_format)format, render, NULL, user_data) != 0) {
+        ma_bridge_stream_free(pStream);
+        return NULL;
+    }
+    return pStream;
+}
+
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_capture(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format) {
+    if (format != ma_bridge_format_s16 && format != ma_bridge_format_s24 && format != ma_bridge_format_s32 && format != ma_bridge_format_f32) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_warning, "Unsupported FIFO format: %d", (int)format);
+        return NULL;
+    }
+
+    ma_bridge_stream* pStream = ma_bridge_stream_alloc();
+    if (!pStream) return NULL;
+
+    if (ma_bridge_stream_init_device(pStream, ma_device_type_capture, NULL, device_id, sample_rate, channels, buffer_frames, (ma_format)format, NULL, NULL, NULL) != 0) {
+        ma_bridge_stream_free(pStream);
+        return NULL;
+    }
+    return pStream;
+}
+
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_duplex(void* playback_device_id, void* capture_device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format, ma_bridge_duplex_proc process, void* user_data) {
+    if (format != ma_bridge_format_s16 && format != ma_bridge_format_s24 && format != ma_bridge_format_s32 && format != ma_bridge_format_f32) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_warning, "Unsupported FIFO format: %d", (int)format);
+        return NULL;
+    }
+
+    ma_bridge_stream* pStream = ma_bridge_stream_alloc();
+    if (!pStream) return NULL;
+
+    if (ma_bridge_stream_init_device(pStream, ma_device_type_duplex, playback_device_id, capture_device_id, sample_rate, channels, buffer_frames, (ma_format)format, NULL, process, user_data) != 0) {
+        ma_bridge_stream_free(pStream);
+        return NULL;
+    }
+    return pStream;
+}
+
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_offline(int sample_rate, int channels, int buffer_frames, ma_bridge_format format, ma_bridge_format device_format) {
+    if (format != ma_bridge_format_s16 && format != ma_bridge_format_s24 && format != ma_bridge_format_s32 && format != ma_bridge_format_f32) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_warning, "Unsupported FIFO format: %d", (int)format);
+        return NULL;
+    }
+    if ((ma_format)device_format == ma_format_unknown) device_format = format;
+    if ((ma_format)device_format <= ma_format_unknown || (ma_format)device_format >= ma_format_count) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_warning, "Unsupported device format: %d", (int)device_format);
+        return NULL;
+    }
+    if (sample_rate <= 0 || channels <= 0 || buffer_frames <= 0) return NULL;
+
+    ma_bridge_stream* pStream = ma_bridge_stream_alloc();
+    if (!pStream) return NULL;
+
+    ma_bridge_stream_init_state(pStream, ma_device_type_playback, channels, (ma_format)format);
+    pStream->device_format = (ma_format)device_format;
+    pStream->sample_rate = (ma_uint32)sample_rate;
+    pStream->output_latency_frames = (ma_uint32)buffer_frames; // One period in flight
+
+    ma_bridge_offline* pOffline = &pStream->offline;
+    pOffline->output = malloc((size_t)buffer_frames * ma_get_bytes_per_frame((ma_format)device_format, (ma_uint32)channels));
+    if (!pOffline->output) {
+        ma_bridge_stream_free(pStream);
+        return NULL;
+    }
+    pOffline->period_frames = (ma_uint32)buffer_frames;
+    pOffline->origin_ns = ma_bridge_now_ns();
+    ma_bridge_waiter_init(&pOffline->waiter);
+    ma_bridge_offline_set_clock(pOffline, 0, 0, 0, pStream->sample_rate);
+    pOffline->enabled = MA_TRUE;
+
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "Offline stream. Rate: %d, Channels: %d, BufferFrames: %d, Format: %s -> %s", sample_rate, channels, buffer_frames, ma_get_format_name((ma_format)format), ma_get_format_name((ma_format)device_format));
+    return pStream;
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_stream_set_offline_clock(ma_bridge_stream* pStream, float speed, int32_t jitter_us, uint32_t seed) {
+    if (!pStream || !pStream->offline.enabled || pStream->device_started) return -1;
+    ma_bridge_offline_set_clock(&pStream->offline, speed, jitter_us > 0 ? (ma_uint32)jitter_us * 1000u : 0, seed, pStream->sample_rate);
+    return 0;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_pump(ma_bridge_stream* pStream, int32_t periods, void* output) {
+    if (!pStream || !pStream->offline.enabled || pStream->offline.thread_started) return -1;
+
+    ma_bridge_offline* pOffline = &pStream->offline;
+    ma_uint32 period_bytes = pOffline->period_frames * ma_get_bytes_per_frame(pStream->device_format, pStream->channels);
+    int32_t delivered = 0;
+    for (int32_t i = 0; i < periods; i++) {
+        void* pOutput = output ? (ma_uint8*)output + (size_t)i * period_bytes : pOffline->output;
+        delivered += (int32_t)ma_bridge_offline_step(pStream, pOutput, ma_bridge_offline_period_start_ns(pOffline, pStream->sample_rate));
     }
-    
-    return -1;
+    return delivered;
 }
 
+MA_BRIDGE_EXPORT void ma_bridge_stream_destroy(ma_bridge_stream* pStream) {
+    if (!pStream) return;
+    ma_bridge_stream_uninit(pStream);
+    if (pStream != &g_stream) ma_bridge_stream_free(pStream);
+}
 
-/* --- Device API (Low Level Stream) --- */
+MA_BRIDGE_EXPORT void ma_bridge_stream_uninit(ma_bridge_stream* pStream) {
+    if (!pStream) return;
+    ma_bridge_stream_stop(pStream);
+    ma_bridge_notifier_stop(&pStream->notifier);
 
-static void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
-    (void)pInput;
-    (void)pDevice;
-    
-    int16_t* output = (int16_t*)pOutput;
-    int samples_needed = frameCount * g_channels;
-    
-    if (g_fifo == NULL || g_read_pos == NULL || g_write_pos == NULL) {
-        memset(output, 0, samples_needed * sizeof(int16_t));
-        return;
-    }
-    
-    int read = *g_read_pos;
-    int write = *g_write_pos;
-    
-    int available;
-    if (write >= read) {
-        available = write - read;
-    } else {
-        available = g_fifo_capacity - read + write;
-    }
-    
-    int samples_to_read = (available < samples_needed) ? available : samples_needed;
-    int frames_to_read = samples_to_read / g_channels;
-    
-    for (int i = 0; i < samples_to_read; i++) {
-        output[i] = g_fifo[(read + i) % g_fifo_capacity];
-    }
-    
-    if (samples_to_read < samples_needed) {
-        memset(output + samples_to_read, 0, (samples_needed - samples_to_read) * sizeof(int16_t));
+    // Safety: Clear pointers to Dart memory BEFORE uninit.
+    ma_bridge_ring_init(&pStream->ring, NULL, 0, pStream->format, NULL);
+    ma_bridge_ring_init(&pStream->capture_ring, NULL, 0, pStream->format, NULL);
+    ma_bridge_waiter_signal(&pStream->waiter); // Blocked producers and readers re-check and bail out
+
+    ma_bridge_stream_uninit_resampler(pStream); // Ensure resampler is cleaned up
+    ma_bridge_stream_uninit_pull_resampler(pStream);
+
+    if (pStream->device_initialized) {
+        ma_device_uninit(&pStream->device);
+        pStream->device_initialized = 0;
     }
-    
-    *g_read_pos = (read + samples_to_read) % g_fifo_capacity;
-    g_frames_consumed += frames_to_read;
-    
-    // Debug Log (Throttled)
-    /*
-    static int cb_count = 0;
-    cb_count++;
-    if (cb_count % 100 == 0) {
-        // printf("[miniaudio_bridge] Callback fired. Req: %d, Read: %d frames. Total Consumed: %llu\n", frameCount, frames_to_read, g_frames_consumed);
+    if (pStream->offline.enabled) {
+        ma_bridge_offline_stop(pStream);
+        free(pStream->offline.output);
+        pStream->offline.output = NULL;
+        pStream->offline.enabled = MA_FALSE;
     }
-    */
+    pStream->device_started = 0;
 }
 
-MA_BRIDGE_EXPORT int ma_bridge_init_with_device_id(void* device_id, int sample_rate, int channels, int buffer_frames) {
-    if (g_device_initialized) ma_bridge_deinit(); // Deinit device only
-    EnsureContextInit(); // Context is reused
-    
-    g_channels = channels;
-    g_frames_consumed = 0;
-    
-    ma_device_config config = ma_device_config_init(ma_device_type_playback);
-    config.playback.format = ma_format_s16;
-    config.playback.channels = channels;
-    config.playback.pDeviceID = (ma_device_id*)device_id; // Can be NULL
-    config.sampleRate = sample_rate;
-    config.dataCallback = data_callback;
-    config.periodSizeInFrames = buffer_frames;
-    config.performanceProfile = ma_performance_profile_low_latency;
-    
-    ma_result result = ma_device_init(&g_context, &config, &g_device);
-    if (result != MA_SUCCESS) {
-        printf("[miniaudio_bridge] Failed to init device: %d\n", result);
-        return -1;
-    }
-    
-    printf("[miniaudio_bridge] Device Initialized. Rate: %d, Channels: %d, BufferFrames: %d\n", sample_rate, channels, buffer_frames);
-    g_device_initialized = 1;
-    return 0;
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_fifo(ma_bridge_stream* pStream, void* fifo_ptr, int capacity_samples, ma_bridge_fifo_positions* positions) {
+    if (!pStream) return;
+    if (capacity_samples < 0) capacity_samples = 0;
+    ma_bridge_ring_init(&pStream->ring, fifo_ptr, (ma_uint32)capacity_samples, pStream->format, positions);
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "FIFO configured. Capacity: %d samples (%s)", capacity_samples, pStream->ring.mask ? "masked ring" : "modulo ring");
 }
 
-MA_BRIDGE_EXPORT int ma_bridge_init(int sample_rate, int channels, int buffer_frames) {
-    return ma_bridge_init_with_device_id(NULL, sample_rate, channels, buffer_frames);
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_capture_fifo(ma_bridge_stream* pStream, void* fifo_ptr, int capacity_samples, ma_bridge_fifo_positions* positions) {
+    if (!pStream) return;
+    if (capacity_samples < 0) capacity_samples = 0;
+    ma_bridge_ring_init(&pStream->capture_ring, fifo_ptr, (ma_uint32)capacity_samples, pStream->format, positions);
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "Capture FIFO configured. Capacity: %d samples (%s)", capacity_samples, pStream->capture_ring.mask ? "masked ring" : "modulo ring");
 }
 
-MA_BRIDGE_EXPORT void ma_bridge_set_fifo(int16_t* fifo_ptr, int capacity_samples, volatile int* read_pos, volatile int* write_pos) {
-    g_fifo = fifo_ptr;
-    g_fifo_capacity = capacity_samples;
-    g_read_pos = read_pos;
-    g_write_pos = write_pos;
-    if (read_pos) *read_pos = 0;
-    if (write_pos) *write_pos = 0;
-    printf("[miniaudio_bridge] FIFO configured. Capacity: %d samples\n", capacity_samples);
-}
+MA_BRIDGE_EXPORT int ma_bridge_stream_start(ma_bridge_stream* pStream) {
+    if (!pStream || !ma_bridge_stream_is_open(pStream)) return -1;
+    if (pStream->device_started) return 0;
 
-MA_BRIDGE_EXPORT int ma_bridge_start(void) {
-    if (!g_device_initialized) return -1;
-    if (g_device_started) return 0;
+    if (pStream->offline.enabled) {
+        if (ma_bridge_offline_start(pStream) != 0) return -1;
+        pStream->device_started = 1;
+        return 0;
+    }
     
-    printf("[miniaudio_bridge] Starting device...\n");
-    if (ma_device_start(&g_device) != MA_SUCCESS) {
-        printf("[miniaudio_bridge] Failed to start device!\n");
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "Starting device...");
+    if (ma_device_start(&pStream->device) != MA_SUCCESS) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_error, "Failed to start device!");
         return -1;
     }
-    printf("[miniaudio_bridge] Device started successfully\n");
-    g_device_started = 1;
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "Device started successfully");
+    pStream->device_started = 1;
     return 0;
 }
 
-MA_BRIDGE_EXPORT int ma_bridge_stop(void) {
-    if (!g_device_initialized || !g_device_started) return 0;
-    if (ma_device_stop(&g_device) != MA_SUCCESS) return -1;
-    g_device_started = 0;
+MA_BRIDGE_EXPORT int ma_bridge_stream_stop(ma_bridge_stream* pStream) {
+    if (!pStream || !ma_bridge_stream_is_open(pStream) || !pStream->device_started) return 0;
+    if (pStream->offline.enabled) {
+        ma_bridge_offline_stop(pStream);
+    } else if (ma_device_stop(&pStream->device) != MA_SUCCESS) {
+        return -1;
+    }
+    pStream->device_started = 0;
     return 0;
 }
 
-MA_BRIDGE_EXPORT uint64_t ma_bridge_get_frames_consumed(void) {
-    return g_frames_consumed;
+MA_BRIDGE_EXPORT uint64_t ma_bridge_stream_get_frames_consumed(ma_bridge_stream* pStream) {
+    return pStream ? ma_atomic_load_explicit_64(&pStream->stats.frames_consumed, ma_atomic_memory_order_relaxed) : 0;
 }
 
-MA_BRIDGE_EXPORT int32_t ma_bridge_get_fifo_available(void) {
-    if (!g_read_pos || !g_write_pos) return 0;
-    int r = *g_read_pos;
-    int w = *g_write_pos;
-    return (w >= r) ? (w - r) : (g_fifo_capacity - r + w);
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_fifo_available(ma_bridge_stream* pStream) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->ring)) return 0;
+    return (int32_t)ma_bridge_ring_fill(&pStream->ring);
 }
 
-MA_BRIDGE_EXPORT void ma_bridge_set_volume(float volume) {
-    if (g_device_initialized) ma_device_set_master_volume(&g_device, volume);
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_volume(ma_bridge_stream* pStream, float volume) {
+    if (pStream && pStream->device_initialized) ma_device_set_master_volume(&pStream->device, volume);
 }
 
-MA_BRIDGE_EXPORT int32_t ma_bridge_get_device_sample_rate(void) {
-    return g_device_initialized ? g_device.sampleRate : 0;
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_device_sample_rate(ma_bridge_stream* pStream) {
+    return (pStream && ma_bridge_stream_is_open(pStream)) ? (int32_t)pStream->sample_rate : 0;
 }
 
-MA_BRIDGE_EXPORT int32_t ma_bridge_get_device_channels(void) {
-    return g_device_initialized ? g_device.playback.channels : 0;
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_device_channels(ma_bridge_stream* pStream) {
+    if (!pStream || !ma_bridge_stream_is_open(pStream)) return 0;
+    if (pStream->offline.enabled) return pStream->channels;
+    return (pStream->device_type == ma_device_type_capture) ? pStream->device.capture.channels : pStream->device.playback.channels;
 }
 
 /* Resampler Control */
-static ma_resampler g_resampler;
-static int g_resampler_initialized = 0;
-static ma_uint32 g_resampler_rate_in = 0;
-static ma_uint32 g_resampler_rate_out = 0;
-// We need an intermediate buffer for resampled output before writing to ring buffer
-static int16_t* g_resample_buffer_out = NULL;
-static int g_resample_buffer_capacity = 0; // in samples (frames * channels)
 
-MA_BRIDGE_EXPORT int ma_bridge_init_resampler(int sourceSampleRate, int targetSampleRate) {
-    if (g_resampler_initialized) {
-        ma_resampler_uninit(&g_resampler, NULL);
-        g_resampler_initialized = 0;
+MA_BRIDGE_EXPORT int ma_bridge_stream_init_resampler(ma_bridge_stream* pStream, int sourceSampleRate, int targetSampleRate) {
+    if (!pStream) return -1;
+    if (pStream->resampler_initialized) {
+        ma_resampler_uninit(&pStream->resampler, NULL);
+        pStream->resampler_initialized = 0;
     }
 
     if (sourceSampleRate == targetSampleRate) {
-        printf("[miniaudio_bridge] Resampler skipped (Rates match: %d)\n", sourceSampleRate);
+        MA_BRIDGE_LOG(ma_bridge_log_level_info, "Resampler skipped (Rates match: %d)", sourceSampleRate);
         return 0;
     }
 
+    // ma_resampler only processes s16 and f32
+    if (pStream->format != ma_format_s16 && pStream->format != ma_format_f32) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_warning, "Resampler needs an s16 or f32 FIFO (got %s)", ma_get_format_name(pStream->format));
+        return -1;
+    }
+
     ma_resampler_config config = ma_resampler_config_init(
-        ma_format_s16, 
-        g_channels, 
+        pStream->format, 
+        pStream->channels, 
         sourceSampleRate, 
         targetSampleRate, 
         ma_resample_algorithm_linear
     );
-    // Linear is fastest. Sinc not available in this build.
+    ma_bridge_sinc_config(&config, pStream->resample_quality);
 
-    if (ma_resampler_init(&config, NULL, &g_resampler) != MA_SUCCESS) {
-        printf("[miniaudio_bridge] Failed to init resampler!\n");
+    if (ma_resampler_init(&config, NULL, &pStream->resampler) != MA_SUCCESS) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_error, "Failed to init resampler!");
         return -1;
     }
 
-    // Allocate a large enough output buffer (e.g. 2x input size just to be safe for upsampling)
-    // We assume typical write sizes ~1024 frames. 
-    // Let's allocate enough for ~8192 frames output to be safe.
-    int safe_cap_frames = 8192;
-    int safe_cap_samples = safe_cap_frames * g_channels;
-    
-    if (g_resample_buffer_out) free(g_resample_buffer_out);
-    g_resample_buffer_out = (int16_t*)malloc(safe_cap_samples * sizeof(int16_t));
-    g_resample_buffer_capacity = safe_cap_samples;
-
-    g_resampler_initialized = 1;
-    g_resampler_rate_in = sourceSampleRate;
-    g_resampler_rate_out = targetSampleRate;
-    printf("[miniaudio_bridge] Resampler Initialized. %d -> %d\n", sourceSampleRate, targetSampleRate);
+    pStream->resampler_initialized = 1;
+    pStream->resampler_rate_in = sourceSampleRate;
+    pStream->resampler_rate_out = targetSampleRate;
+    ma_atomic_store_explicit_f32(&pStream->drc.pending.base_ratio, (float)sourceSampleRate / (float)targetSampleRate, ma_atomic_memory_order_relaxed);
+    ma_bridge_drc_publish(&pStream->drc);
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "Resampler Initialized. %d -> %d (quality %d)", sourceSampleRate, targetSampleRate, (int)pStream->resample_quality);
     return 0;
 }
 
-MA_BRIDGE_EXPORT void ma_bridge_uninit_resampler(void) {
-    if (g_resampler_initialized) {
-        ma_resampler_uninit(&g_resampler, NULL);
-        g_resampler_initialized = 0;
-    }
-    if (g_resample_buffer_out) {
-        free(g_resample_buffer_out);
-        g_resample_buffer_out = NULL;
+MA_BRIDGE_EXPORT void ma_bridge_stream_uninit_resampler(ma_bridge_stream* pStream) {
+    if (!pStream) return;
+    if (pStream->resampler_initialized) {
+        ma_resampler_uninit(&pStream->resampler, NULL);
+        pStream->resampler_initialized = 0;
     }
 }
 
-MA_BRIDGE_EXPORT void ma_bridge_set_resampling_ratio(float ratio) {
-    if (g_resampler_initialized) {
-        ma_resampler_set_rate_ratio(&g_resampler, ratio);
-        // printf("[miniaudio_bridge] Resampler ratio set to: %f\n", ratio);
-    }
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_resample_quality(ma_bridge_stream* pStream, int quality) {
+    if (!pStream) return;
+    if (quality < ma_bridge_resample_quality_linear || quality > ma_bridge_resample_quality_high) quality = ma_bridge_resample_quality_linear;
+    pStream->resample_quality = (ma_bridge_resample_quality)quality;
 }
 
+MA_BRIDGE_EXPORT int ma_bridge_stream_init_pull_resampler(ma_bridge_stream* pStream, int sourceSampleRate) {
+    if (!pStream || !ma_bridge_stream_is_open(pStream)) return -1;
+    if (pStream->device_started) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_warning, "Pull resampler must be configured while stopped");
+        return -1;
+    }
 
-/* --- Engine API (High Level) --- */
+    ma_bridge_stream_uninit_pull_resampler(pStream);
+    if (sourceSampleRate <= 0) return 0; // Disable
 
-MA_BRIDGE_EXPORT int32_t ma_bridge_write_device_fifo(int16_t* data, int32_t frameCount) {
-    if (!g_fifo || !g_write_pos || !g_read_pos) return 0;
+    ma_bridge_stream_uninit_resampler(pStream); // The producer now writes source-rate audio as-is
 
-    int read = *g_read_pos;
-    int write = *g_write_pos;
-    int capacity = g_fifo_capacity;
+    ma_resampler_config config = ma_resampler_config_init(ma_format_f32, pStream->channels, (ma_uint32)sourceSampleRate, pStream->sample_rate, ma_resample_algorithm_linear);
+    ma_bridge_sinc_config(&config, pStream->resample_quality);
+    if (ma_resampler_init(&config, NULL, &pStream->pull_resampler) != MA_SUCCESS) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_error, "Failed to init pull resampler!");
+        return -1;
+    }
+    pStream->pull_resampling = 1;
 
-    // Logic for "Space Available to Write":
-    int freeSamples;
-    if (write >= read) {
-        freeSamples = capacity - (write - read) - 1; /* Keep 1 sample gap */
-    } else {
-        freeSamples = read - write - 1;
+    pStream->pull_in = (float*)malloc((size_t)MA_BRIDGE_PULL_INPUT_FRAMES * pStream->channels * sizeof(float));
+    pStream->pull_out = (float*)malloc((size_t)MA_BRIDGE_PULL_CHUNK_FRAMES * pStream->channels * sizeof(float));
+    if (!pStream->pull_in || !pStream->pull_out) {
+        ma_bridge_stream_uninit_pull_resampler(pStream);
+        return -1;
     }
-    
-    int framesToWrite = frameCount;
-    int samplesToWrite = framesToWrite * g_channels;
 
-    if (samplesToWrite > freeSamples) {
+    ma_atomic_store_explicit_f32(&pStream->drc.pending.base_ratio, (float)sourceSampleRate / (float)pStream->sample_rate, ma_atomic_memory_order_relaxed);
+    ma_bridge_drc_publish(&pStream->drc);
+    MA_BRIDGE_LOG(ma_bridge_log_level_info, "Pull Resampler Initialized. %d -> %u", sourceSampleRate, pStream->sample_rate);
+    return 0;
+}
+
+/*
+ * Rate settings go through the controller's pending block: it runs on the
+ * producer (push) or the audio thread (pull), and applies them from its
+ * next write or period.
+ */
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_resampling_ratio(ma_bridge_stream* pStream, float ratio) {
+    if (!pStream || ratio <= 0) return;
+    ma_atomic_store_explicit_f32(&pStream->drc.pending.base_ratio, ratio, ma_atomic_memory_order_relaxed);
+    ma_bridge_drc_publish(&pStream->drc);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_playback_speed(ma_bridge_stream* pStream, float speed) {
+    if (!pStream || speed <= 0) return;
+    ma_atomic_store_explicit_f32(&pStream->drc.pending.speed, speed, ma_atomic_memory_order_relaxed);
+    ma_bridge_drc_publish(&pStream->drc);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_rate_control(ma_bridge_stream* pStream, int32_t target_latency_frames, float max_skew) {
+    if (!pStream) return;
+    ma_atomic_store_explicit_32(&pStream->drc.pending.target_frames, target_latency_frames > 0 ? (ma_uint32)target_latency_frames : 0, ma_atomic_memory_order_relaxed);
+    ma_atomic_store_explicit_f32(&pStream->drc.pending.max_skew, max_skew > 0 ? max_skew : 0, ma_atomic_memory_order_relaxed);
+    ma_bridge_drc_publish(&pStream->drc);
+}
+
+MA_BRIDGE_EXPORT float ma_bridge_stream_get_resampling_ratio(ma_bridge_stream* pStream) {
+    return pStream ? ma_atomic_load_explicit_f32(&pStream->drc.ratio, ma_atomic_memory_order_relaxed) : 0.0f;
+}
+
+/* FIFO Writes */
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_write_device_fifo(ma_bridge_stream* pStream, const void* data, int32_t frameCount) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->ring) || frameCount <= 0) return 0;
+
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 freeSamples = pStream->ring.capacity - ma_bridge_ring_fill(&pStream->ring);
+    ma_uint32 framesToWrite = (ma_uint32)frameCount;
+
+    if (framesToWrite * channels > freeSamples) {
         // Log when we clip (buffer full)
-        MA_LOG("[miniaudio_bridge] Buffer FULL. Write: %d, Read: %d, Free: %d, Req: %d\n", write, read, freeSamples, samplesToWrite);
-        samplesToWrite = freeSamples;
-        framesToWrite = samplesToWrite / g_channels;
+        MA_BRIDGE_LOG(ma_bridge_log_level_debug, "Buffer FULL. Free: %u, Req: %u", freeSamples, framesToWrite * channels);
+        framesToWrite = freeSamples / channels;
     }
 
-    if (samplesToWrite <= 0) {
-        MA_LOG("[miniaudio_bridge] Buffer FULL (0 space). Write: %d, Read: %d\n", write, read);
+    ma_bridge_stats_record_overrun(&pStream->stats, (ma_uint32)frameCount, framesToWrite);
+
+    if (framesToWrite == 0) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_debug, "Buffer FULL (0 space)");
         return 0;
     }
 
-    int samplesFirstChunk = capacity - write;
-    if (samplesToWrite < samplesFirstChunk) {
-        samplesFirstChunk = samplesToWrite;
+    // Release-publishes the new write position after both copies land
+    ma_bridge_ring_write(&pStream->ring, data, framesToWrite * channels);
+    return (int32_t)framesToWrite;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_fifo_reserve(ma_bridge_stream* pStream, int32_t frames, void** ptr1, int32_t* len1, void** ptr2, int32_t* len2) {
+    void* pSeg1 = NULL;
+    void* pSeg2 = NULL;
+    ma_uint32 samples1 = 0, samples2 = 0;
+    ma_uint32 channels = pStream ? (ma_uint32)pStream->channels : 1;
+
+    if (pStream && ma_bridge_ring_is_valid(&pStream->ring) && frames > 0) {
+        ma_bridge_ring_reserve_write(&pStream->ring, (ma_uint32)frames * channels, &pSeg1, &samples1, &pSeg2, &samples2);
+
+        // A frame must not straddle the wrap; only possible when capacity isn't a multiple of channels
+        if (samples1 % channels != 0) {
+            samples1 -= samples1 % channels;
+            samples2 = 0;
+        }
+        samples2 -= samples2 % channels;
+        if (samples2 == 0) pSeg2 = NULL;
     }
-    
-    // Copy part 1
-    memcpy(g_fifo + write, data, samplesFirstChunk * sizeof(int16_t));
-    
-    // Copy part 2 (Wrap)
-    if (samplesToWrite > samplesFirstChunk) {
-        memcpy(g_fifo, data + samplesFirstChunk, (samplesToWrite - samplesFirstChunk) * sizeof(int16_t));
+
+    ma_uint32 reserved = (samples1 + samples2) / channels;
+    if (pStream && ma_bridge_ring_is_valid(&pStream->ring) && frames > 0) {
+        ma_bridge_stats_record_overrun(&pStream->stats, (ma_uint32)frames, reserved);
     }
 
-    // MEMORY BARRIER: Ensure data is committed before updating write_pos
-    __sync_synchronize(); 
+    if (ptr1) *ptr1 = pSeg1;
+    if (len1) *len1 = (int32_t)(samples1 / channels);
+    if (ptr2) *ptr2 = pSeg2;
+    if (len2) *len2 = (int32_t)(samples2 / channels);
+    return (int32_t)reserved;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_fifo_commit(ma_bridge_stream* pStream, int32_t frames) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->ring) || frames <= 0) return 0;
 
-    // Update write position
-    *g_write_pos = (write + samplesToWrite) % capacity;
-    
-    return framesToWrite;
+    // Never publish more than is actually free (e.g. a stale reservation)
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 freeFrames = (pStream->ring.capacity - ma_bridge_ring_fill(&pStream->ring)) / channels;
+    ma_uint32 framesToCommit = (ma_uint32)frames;
+    if (framesToCommit > freeFrames) framesToCommit = freeFrames;
+
+    ma_bridge_ring_commit_write(&pStream->ring, framesToCommit * channels);
+    return (int32_t)framesToCommit;
 }
 
-MA_BRIDGE_EXPORT int32_t ma_bridge_write_pcm_frames(int16_t* data, int32_t frameCount) {
-    if (!g_resampler_initialized) {
-        return ma_bridge_write_device_fifo(data, frameCount);
-    }
-    if (!g_resample_buffer_out || !g_fifo || !g_read_pos || !g_write_pos) return 0;
+/*
+ * Resample into `frames` contiguous frames of reserved ring memory, publishing
+ * every MA_BRIDGE_RESAMPLE_CHUNK_FRAMES so the callback can start draining a
+ * large catch-up write before it is finished. Stops early when the input runs
+ * out. Returns frames produced; *pConsumed advances by the input used.
+ */
+static ma_uint32 ma_bridge_stream_resample_into_ring(ma_bridge_stream* pStream, const ma_uint8* pIn, ma_uint64 inFrames, ma_uint64* pConsumed, ma_uint8* pOut, ma_uint32 frames) {
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    size_t frameBytes = (size_t)channels * pStream->ring.bytes_per_sample;
+    ma_uint32 produced = 0;
+
+    while (produced < frames && *pConsumed < inFrames) {
+        ma_uint64 framesIn = inFrames - *pConsumed;
+        ma_uint64 framesOut = frames - produced;
+        if (framesOut > MA_BRIDGE_RESAMPLE_CHUNK_FRAMES) framesOut = MA_BRIDGE_RESAMPLE_CHUNK_FRAMES;
+
+        ma_result result = ma_resampler_process_pcm_frames(&pStream->resampler, pIn + *pConsumed * frameBytes, &framesIn, pOut + (size_t)produced * frameBytes, &framesOut);
+        if (result != MA_SUCCESS) {
+            MA_BRIDGE_LOG(ma_bridge_log_level_debug, "Resampling failed: %d", result);
+            break;
+        }
 
-    // 1. Calculate Space Available in Output FIFO
-    int read = *g_read_pos;
-    int write = *g_write_pos;
-    int capacity = g_fifo_capacity; // capacity in samples
-    int free_samples;
-    
-    if (write >= read) {
-        free_samples = capacity - (write - read) - 1;
-    } else {
-        free_samples = read - write - 1;
+        *pConsumed += framesIn;
+        produced += (ma_uint32)framesOut;
+        if (framesOut > 0) ma_bridge_ring_commit_write(&pStream->ring, (ma_uint32)framesOut * channels);
+        if (framesIn == 0 && framesOut == 0) break;
+    }
+    return produced;
+}
+
+static int32_t ma_bridge_stream_write_resampled(ma_bridge_stream* pStream, const void* data, int32_t frameCount) {
+    if (!pStream->resampler_initialized || !ma_bridge_ring_is_valid(&pStream->ring) || frameCount <= 0) return 0;
+
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 bytesPerSample = pStream->ring.bytes_per_sample;
+
+    // 1. Space available in the FIFO
+    ma_uint32 capacity_frames = pStream->ring.capacity / channels;
+    ma_uint32 fill_frames = ma_bridge_ring_fill(&pStream->ring) / channels;
+    if (fill_frames >= capacity_frames) return 0; // FIFO Full
+
+    // 2. Dynamic Rate Control: steer the ratio toward the target fill
+    ma_bridge_resampler_apply_ratio(&pStream->resampler, ma_bridge_drc_update(&pStream->drc, fill_frames, capacity_frames));
+
+    // 3. Reserve all free space; the resampler writes straight into ring memory
+    void* pSeg[2];
+    ma_uint32 segSamples[2];
+    ma_bridge_ring_reserve_write(&pStream->ring, (capacity_frames - fill_frames) * channels, &pSeg[0], &segSamples[0], &pSeg[1], &segSamples[1]);
+
+    // 4. Resample segment by segment until the input or the space runs out
+    const ma_uint8* pIn = (const ma_uint8*)data;
+    ma_uint64 consumed = 0;
+    for (int s = 0; s < 2 && pSeg[s] != NULL; ++s) {
+        ma_uint32 wholeFrames = segSamples[s] / channels;
+        if (ma_bridge_stream_resample_into_ring(pStream, pIn, (ma_uint64)frameCount, &consumed, (ma_uint8*)pSeg[s], wholeFrames) < wholeFrames) break;
+
+        // A frame straddles the wrap only when the capacity is not a multiple of channels
+        ma_uint32 tail = segSamples[s] % channels;
+        if (tail != 0) {
+            if (consumed >= (ma_uint64)frameCount) break;
+            float bounce[MA_MAX_CHANNELS]; /* One frame; s16 and f32 both fit */
+            size_t frameBytes = (size_t)channels * bytesPerSample;
+            size_t tailBytes = (size_t)tail * bytesPerSample;
+            ma_uint64 framesIn = (ma_uint64)frameCount - consumed;
+            ma_uint64 framesOut = 1;
+            if (ma_resampler_process_pcm_frames(&pStream->resampler, pIn + consumed * frameBytes, &framesIn, bounce, &framesOut) != MA_SUCCESS) break;
+            consumed += framesIn;
+            if (framesOut == 0) break;
+
+            memcpy((ma_uint8*)pSeg[0] + (size_t)wholeFrames * frameBytes, bounce, tailBytes);
+            memcpy(pSeg[1], (const ma_uint8*)bounce + tailBytes, frameBytes - tailBytes);
+            ma_bridge_ring_commit_write(&pStream->ring, channels);
+            pSeg[1] = (ma_uint8*)pSeg[1] + (frameBytes - tailBytes);
+            segSamples[1] -= channels - tail;
+        }
     }
-    int free_frames_out = free_samples / g_channels;
 
-    if (free_frames_out <= 0) return 0; // FIFO Full
+    // Return frames consumed from INPUT
+    return (int32_t)consumed;
+}
 
-    // 2. Calculate Estimate Max Input we can consume
-    // We want to know: How many INPUT frames will generate <= free_frames_out OUTPUT frames?
-    ma_uint64 max_input_frames = 0;
-    
-    // API: ma_resampler_get_required_input_frame_count(resampler, outputFrameCount, inputFrameCount)
-    // Note: If function not available, we use approximation: input = output * (inRate / outRate)
-    ma_result res = ma_resampler_get_required_input_frame_count(&g_resampler, free_frames_out, &max_input_frames);
-    
-    if (res != MA_SUCCESS) {
-        // Fallback approximation if API fails (unlikely)
-        // Ratio is roughly in/out? No, ratio is dynamic.
-        // float ratio = g_resampler.rate; // internal structure might be opaque
-        // Just fail safe
-        return 0; 
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_write_pcm_frames(ma_bridge_stream* pStream, const void* data, int32_t frameCount) {
+    if (!pStream) return 0;
+    if (!pStream->resampler_initialized) {
+        return ma_bridge_stream_write_device_fifo(pStream, data, frameCount);
+    }
+
+    int32_t consumed = ma_bridge_stream_write_resampled(pStream, data, frameCount);
+    if (frameCount > 0 && ma_bridge_ring_is_valid(&pStream->ring)) {
+        ma_bridge_stats_record_overrun(&pStream->stats, (ma_uint32)frameCount, (ma_uint32)consumed);
     }
+    return consumed;
+}
+
+MA_BRIDGE_EXPORT const ma_bridge_stream_stats* ma_bridge_stream_get_stats(ma_bridge_stream* pStream) {
+    return pStream ? &pStream->stats : NULL;
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_stream_reset_stats(ma_bridge_stream* pStream) {
+    if (!pStream) return;
+    ma_atomic_store_explicit_32(&pStream->stats.reset_requested, 1, ma_atomic_memory_order_release);
+    ma_atomic_store_explicit_32(&pStream->capture_stats.reset_requested, 1, ma_atomic_memory_order_release);
+}
+
+MA_BRIDGE_EXPORT uint32_t ma_bridge_stream_stats_sequence(const ma_bridge_stream_stats* pStats) {
+    if (!pStats) return 0;
+    ma_atomic_thread_fence(ma_atomic_memory_order_acquire); /* Field loads before this call stay before the re-read */
+    return ma_atomic_load_explicit_32((ma_uint32*)&pStats->sequence, ma_atomic_memory_order_acquire);
+}
 
-    if (max_input_frames == 0) return 0; // Not enough space for even 1 frame?
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_trace_enabled(ma_bridge_stream* pStream, int enabled) {
+    if (pStream) ma_atomic_store_explicit_32(&pStream->trace_enabled, enabled ? 1 : 0, ma_atomic_memory_order_relaxed);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_drain_trace(ma_bridge_stream* pStream, ma_bridge_callback_trace* out, int32_t max) {
+    if (!pStream || (out && max <= 0)) return 0;
+    return (int32_t)ma_bridge_trace_drain(&pStream->trace, out, (ma_uint32)max, pStream->sample_rate);
+}
 
-    // 3. Cap Input
-    ma_uint64 framesInToProcess = (ma_uint64)frameCount;
-    if (framesInToProcess > max_input_frames) {
-        framesInToProcess = max_input_frames;
+MA_BRIDGE_EXPORT void ma_bridge_stream_get_trace_summary(ma_bridge_stream* pStream, ma_bridge_trace_summary* out) {
+    if (!out) return;
+    if (!pStream) {
+        memset(out, 0, sizeof(*out));
+        return;
     }
+    *out = pStream->trace.summary;
+    out->dropped = ma_atomic_load_explicit_64(&pStream->trace.dropped, ma_atomic_memory_order_relaxed) - pStream->trace.dropped_base;
+}
 
-    if (framesInToProcess == 0) return 0;
+MA_BRIDGE_EXPORT void ma_bridge_stream_reset_trace_summary(ma_bridge_stream* pStream) {
+    if (pStream) ma_bridge_trace_reset_summary(&pStream->trace);
+}
 
-    // 4. Dynamic Rate Control (Audio Sync)
-    // Target: 50% Buffer Fill.
-    // If < 50%, Decrease Ratio (Play Slower, consume less input).
-    // If > 50%, Increase Ratio (Play Faster, consume more input).
-    
-    float currentFill = (float)(capacity - free_samples) / (float)capacity;
-    float targetFill = 0.5f;
-    float error = currentFill - targetFill; // Range -0.5 to +0.5
-    
-    // P-Factor: Specific to Libretro/Emulator limits.
-    // Too high = pitch wow/flutter. Too low = drift/underrun.
-    // 0.05 implies 5% max adjustment (approx semitone).
-    // Start conservative: 0.01 (1%).
-    float gain = 0.01f; 
-    
-    float adjustment = error * gain;
-    
-    // Base Ratio: source / target
-    // We don't store base ratio in global currently, but we can recalculate or store it.
-    // Ideally we store it. For now, assume current ratio is close to base.
-    // Better: Retrieve current ratio? ma_resampler doesn't expose getter easily in struct.
-    // Hack: We stored base config. Or we just calculate it here?
-    // Hack: We stored base config. Or we just calculate it here?
-    // Let's recalculate it:
-    float baseRatio = (float)g_resampler_rate_in / (float)g_resampler_rate_out;
-    
-    float newRatio = baseRatio * (1.0f + adjustment);
-    
-    // Clamp to reasonable limits (e.g. +/- 5%)
-    if (newRatio < baseRatio * 0.95f) newRatio = baseRatio * 0.95f;
-    if (newRatio > baseRatio * 1.05f) newRatio = baseRatio * 1.05f;
-    
-    ma_resampler_set_rate_ratio(&g_resampler, newRatio);
+MA_BRIDGE_EXPORT int ma_bridge_stream_get_timestamp(ma_bridge_stream* pStream, uint64_t* frame_position, uint64_t* host_time_ns) {
+    return pStream ? ma_bridge_clock_read(&pStream->clock, frame_position, host_time_ns) : -1;
+}
 
-    // 5. Resample
-    ma_uint64 framesOutGenerated = (ma_uint64)(g_resample_buffer_capacity / g_channels);
-    ma_uint64 framesInConsumed = framesInToProcess;
-    
-    ma_result result = ma_resampler_process_pcm_frames(
-        &g_resampler, 
-        data, 
-        &framesInConsumed, 
-        g_resample_buffer_out, 
-        &framesOutGenerated
-    );
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_output_latency_frames(ma_bridge_stream* pStream) {
+    return (pStream && ma_bridge_stream_is_open(pStream)) ? (int32_t)pStream->output_latency_frames : 0;
+}
 
-    if (result != MA_SUCCESS) {
-        MA_LOG("[miniaudio_bridge] Resampling failed: %d\n", result);
+MA_BRIDGE_EXPORT int ma_bridge_stream_set_low_water_notify(ma_bridge_stream* pStream, void* post_cobject, int64_t port, int32_t watermark_frames) {
+    if (!pStream) return -1;
+    if (!post_cobject || port == 0 || watermark_frames <= 0) {
+        ma_bridge_notifier_stop(&pStream->notifier);
         return 0;
     }
+    return ma_bridge_notifier_start(&pStream->notifier, (ma_bridge_post_cobject_proc)post_cobject, port, (ma_uint32)watermark_frames);
+}
 
-    // 6. Write to FIFO
-    int written = ma_bridge_write_device_fifo(g_resample_buffer_out, (int)framesOutGenerated);
-    (void)written;
-    
-    // Return frames consumed from INPUT
-    return (int32_t)framesInConsumed;
+/* Shared loop for the wait primitives: waits until min_fill <= fill <= max_fill (in samples). */
+static int ma_bridge_stream_wait_fill(ma_bridge_stream* pStream, ma_bridge_ring* pRing, ma_uint32 min_fill, ma_uint32 max_fill, ma_uint64 timeout_ns) {
+    ma_bridge_waiter* pWaiter = &pStream->waiter;
+    ma_uint64 deadline = ma_bridge_now_ns() + timeout_ns;
+    int result = -1;
+
+    if (!pWaiter->initialized) {
+        /* No device yet: nothing will ever signal, so just check once. */
+        if (!ma_bridge_ring_is_valid(pRing)) return -1;
+        ma_uint32 fill = ma_bridge_ring_fill(pRing);
+        return (fill >= min_fill && fill <= max_fill) ? 0 : -1;
+    }
+
+    /* Register before checking the level so a read in between is never missed. */
+    ma_atomic_fetch_add_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    for (;;) {
+        ma_uint32 seen = ma_atomic_load_explicit_32(&pWaiter->sequence, ma_atomic_memory_order_seq_cst);
+        if (!ma_bridge_ring_is_valid(pRing)) break;
+        ma_uint32 fill = ma_bridge_ring_fill(pRing);
+        if (fill >= min_fill && fill <= max_fill) {
+            result = 0;
+            break;
+        }
+        if (!pStream->device_started) break; /* Nothing is moving the FIFO */
+
+        ma_uint64 now = ma_bridge_now_ns();
+        if (now >= deadline) break;
+        ma_bridge_waiter_sleep(pWaiter, seen, deadline - now);
+    }
+    ma_atomic_fetch_sub_explicit_32(&pWaiter->waiters, 1, ma_atomic_memory_order_seq_cst);
+    return result;
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_stream_wait_for_space(ma_bridge_stream* pStream, int32_t frames, uint64_t timeout_ns) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->ring)) return -1;
+    ma_uint64 wanted = frames > 0 ? (ma_uint64)frames * pStream->channels : 0;
+    if (wanted > pStream->ring.capacity) wanted = pStream->ring.capacity;
+    return ma_bridge_stream_wait_fill(pStream, &pStream->ring, 0, pStream->ring.capacity - (ma_uint32)wanted, timeout_ns);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_stream_wait_below_fill(ma_bridge_stream* pStream, int32_t frames, uint64_t timeout_ns) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->ring)) return -1;
+    ma_uint64 level = frames > 0 ? (ma_uint64)frames * pStream->channels : 0;
+    if (level > pStream->ring.capacity) level = pStream->ring.capacity;
+    return ma_bridge_stream_wait_fill(pStream, &pStream->ring, 0, (ma_uint32)level, timeout_ns);
+}
+
+/* --- Capture FIFO (reader side) --- */
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_capture_fifo_available(ma_bridge_stream* pStream) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->capture_ring)) return 0;
+    return (int32_t)ma_bridge_ring_fill(&pStream->capture_ring);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_capture_acquire(ma_bridge_stream* pStream, int32_t frames, void** ptr1, int32_t* len1, void** ptr2, int32_t* len2) {
+    void* pSeg1 = NULL;
+    void* pSeg2 = NULL;
+    ma_uint32 samples1 = 0, samples2 = 0;
+    ma_uint32 channels = pStream ? (ma_uint32)pStream->channels : 1;
+
+    if (pStream && ma_bridge_ring_is_valid(&pStream->capture_ring) && frames > 0) {
+        ma_bridge_ring_acquire_read(&pStream->capture_ring, (ma_uint32)frames * channels, &pSeg1, &samples1, &pSeg2, &samples2);
+
+        // Same whole-frame rule as fifo_reserve
+        if (samples1 % channels != 0) {
+            samples1 -= samples1 % channels;
+            samples2 = 0;
+        }
+        samples2 -= samples2 % channels;
+        if (samples2 == 0) pSeg2 = NULL;
+    }
+
+    if (ptr1) *ptr1 = (samples1 > 0) ? pSeg1 : NULL;
+    if (len1) *len1 = (int32_t)(samples1 / channels);
+    if (ptr2) *ptr2 = pSeg2;
+    if (len2) *len2 = (int32_t)(samples2 / channels);
+    return (int32_t)((samples1 + samples2) / channels);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_capture_release(ma_bridge_stream* pStream, int32_t frames) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->capture_ring) || frames <= 0) return 0;
+
+    // Never free more than is actually stored (e.g. a stale acquisition)
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 stored = ma_bridge_ring_fill(&pStream->capture_ring) / channels;
+    ma_uint32 framesToRelease = (ma_uint32)frames;
+    if (framesToRelease > stored) framesToRelease = stored;
+
+    ma_bridge_ring_release_read(&pStream->capture_ring, framesToRelease * channels);
+    return (int32_t)framesToRelease;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_read_capture(ma_bridge_stream* pStream, void* data, int32_t frameCount) {
+    if (!pStream || !data || frameCount <= 0 || !ma_bridge_ring_is_valid(&pStream->capture_ring)) return 0;
+    ma_uint32 channels = (ma_uint32)pStream->channels;
+    ma_uint32 frames = ma_bridge_ring_fill(&pStream->capture_ring) / channels;
+    if (frames > (ma_uint32)frameCount) frames = (ma_uint32)frameCount;
+    ma_bridge_ring_read(&pStream->capture_ring, data, pStream->format, frames * channels);
+    return (int32_t)frames;
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_stream_wait_for_capture(ma_bridge_stream* pStream, int32_t frames, uint64_t timeout_ns) {
+    if (!pStream || !ma_bridge_ring_is_valid(&pStream->capture_ring)) return -1;
+    ma_uint64 wanted = frames > 0 ? (ma_uint64)frames * pStream->channels : 0;
+    if (wanted > pStream->capture_ring.capacity) wanted = pStream->capture_ring.capacity;
+    return ma_bridge_stream_wait_fill(pStream, &pStream->capture_ring, (ma_uint32)wanted, pStream->capture_ring.capacity, timeout_ns);
+}
+
+MA_BRIDGE_EXPORT const ma_bridge_stream_stats* ma_bridge_stream_get_capture_stats(ma_bridge_stream* pStream) {
+    return pStream ? &pStream->capture_stats : NULL;
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_stream_get_capture_timestamp(ma_bridge_stream* pStream, uint64_t* frame_position, uint64_t* host_time_ns) {
+    return pStream ? ma_bridge_clock_read(&pStream->capture_clock, frame_position, host_time_ns) : -1;
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_input_latency_frames(ma_bridge_stream* pStream) {
+    return (pStream && ma_bridge_stream_is_open(pStream)) ? (int32_t)pStream->input_latency_frames : 0;
+}
+
+
+/* Legacy single-stream API: forwards to the default stream */
+
+MA_BRIDGE_EXPORT int ma_bridge_init_with_device_id(void* device_id, int sample_rate, int channels, int buffer_frames) {
+    return ma_bridge_stream_init_device(&g_stream, ma_device_type_playback, device_id, NULL, sample_rate, channels, buffer_frames, ma_format_s16, NULL, NULL, NULL);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_init_with_render_callback(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_render_proc render, void* user_data) {
+    return ma_bridge_stream_init_device(&g_stream, ma_device_type_playback, device_id, NULL, sample_rate, channels, buffer_frames, ma_format_s16, render, NULL, user_data);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_init(int sample_rate, int channels, int buffer_frames) {
+    return ma_bridge_init_with_device_id(NULL, sample_rate, channels, buffer_frames);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_set_fifo(int16_t* fifo_ptr, int capacity_samples, ma_bridge_fifo_positions* positions) {
+    ma_bridge_stream_set_fifo(&g_stream, fifo_ptr, capacity_samples, positions);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_start(void) {
+    return ma_bridge_stream_start(&g_stream);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_stop(void) {
+    return ma_bridge_stream_stop(&g_stream);
+}
+
+MA_BRIDGE_EXPORT uint64_t ma_bridge_get_frames_consumed(void) {
+    return ma_bridge_stream_get_frames_consumed(&g_stream);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_get_fifo_available(void) {
+    return ma_bridge_stream_get_fifo_available(&g_stream);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_set_volume(float volume) {
+    ma_bridge_stream_set_volume(&g_stream, volume);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_get_device_sample_rate(void) {
+    return ma_bridge_stream_get_device_sample_rate(&g_stream);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_get_device_channels(void) {
+    return ma_bridge_stream_get_device_channels(&g_stream);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_init_resampler(int sourceSampleRate, int targetSampleRate) {
+    return ma_bridge_stream_init_resampler(&g_stream, sourceSampleRate, targetSampleRate);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_uninit_resampler(void) {
+    ma_bridge_stream_uninit_resampler(&g_stream);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_set_resample_quality(int quality) {
+    ma_bridge_stream_set_resample_quality(&g_stream, quality);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_set_resampling_ratio(float ratio) {
+    ma_bridge_stream_set_resampling_ratio(&g_stream, ratio);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_set_playback_speed(float speed) {
+    ma_bridge_stream_set_playback_speed(&g_stream, speed);
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_set_rate_control(int32_t target_latency_frames, float max_skew) {
+    ma_bridge_stream_set_rate_control(&g_stream, target_latency_frames, max_skew);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_write_device_fifo(int16_t* data, int32_t frameCount) {
+    return ma_bridge_stream_write_device_fifo(&g_stream, data, frameCount);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_fifo_reserve(int32_t frames, int16_t** ptr1, int32_t* len1, int16_t** ptr2, int32_t* len2) {
+    return ma_bridge_stream_fifo_reserve(&g_stream, frames, (void**)ptr1, len1, (void**)ptr2, len2);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_fifo_commit(int32_t frames) {
+    return ma_bridge_stream_fifo_commit(&g_stream, frames);
+}
+
+MA_BRIDGE_EXPORT int32_t ma_bridge_write_pcm_frames(int16_t* data, int32_t frameCount) {
+    return ma_bridge_stream_write_pcm_frames(&g_stream, data, frameCount);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_set_low_water_notify(void* post_cobject, int64_t port, int32_t watermark_frames) {
+    return ma_bridge_stream_set_low_water_notify(&g_stream, post_cobject, port, watermark_frames);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_wait_for_space(int32_t frames, uint64_t timeout_ns) {
+    return ma_bridge_stream_wait_for_space(&g_stream, frames, timeout_ns);
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_wait_below_fill(int32_t frames, uint64_t timeout_ns) {
+    return ma_bridge_stream_wait_below_fill(&g_stream, frames, timeout_ns);
 }
 
 /* --- Engine API (High Level) --- */
 
+static void engine_data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
+    (void)pInput;
+    MA_BRIDGE_RT_ENTER("engine_callback"); // Covers node processing
+    ma_engine_read_pcm_frames((ma_engine*)pDevice->pUserData, pOutput, frameCount, NULL);
+    MA_BRIDGE_RT_LEAVE();
+}
+
 MA_BRIDGE_EXPORT int ma_bridge_engine_init(void) {
     if (g_engine_initialized) return 0;
-    
-    // Engine uses its own internal context/device management usually, 
-    // unless we pass a config. For simplicity, let engine manage itself.
+    if (EnsureContextInit() != MA_SUCCESS) return -1;
+
+    // The engine's device is opened here, on the shared context, so the device
+    // options apply to it; ma_engine would otherwise open one with its defaults.
+    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.playback.format = ma_format_f32; // The engine mixes in f32
+    deviceConfig.dataCallback = engine_data_callback;
+    deviceConfig.pUserData = &g_engine;
+    ma_bridge_apply_device_config(&deviceConfig);
+    deviceConfig.noPreSilencedOutputBuffer = MA_TRUE; // Every frame is mixed
+    deviceConfig.noClip = MA_TRUE; // The engine clips itself
+
+    if (ma_device_init(&g_context, &deviceConfig, &g_engine_device) != MA_SUCCESS) {
+        MA_BRIDGE_LOG(ma_bridge_log_level_error, "Failed to init engine device");
+        return -1;
+    }
+
     ma_engine_config config = ma_engine_config_init();
+    config.pContext = &g_context;
+    config.pDevice = &g_engine_device;
     
     if (ma_engine_init(&config, &g_engine) != MA_SUCCESS) {
-        printf("[miniaudio_bridge] Failed to init engine\n");
+        MA_BRIDGE_LOG(ma_bridge_log_level_error, "Failed to init engine");
+        ma_device_uninit(&g_engine_device);
         return -1;
     }
     g_engine_initialized = 1;
@@ -505,7 +2717,8 @@ MA_BRIDGE_EXPORT int ma_bridge_engine_init(void) {
 
 MA_BRIDGE_EXPORT void ma_bridge_engine_uninit(void) {
     if (g_engine_initialized) {
-        ma_engine_uninit(&g_engine);
+        ma_engine_uninit(&g_engine); // Stops the device it does not own
+        ma_device_uninit(&g_engine_device);
         g_engine_initialized = 0;
     }
 }
@@ -876,7 +3089,7 @@ MA_BRIDGE_EXPORT void ma_bridge_node_detach_output_bus(void* node_handle, int ou
 }
 
 MA_BRIDGE_EXPORT void* ma_bridge_engine_get_endpoint(void) {
-    if (!g_device_initialized) return NULL;
+    if (!g_engine_initialized) return NULL;
     // The endpoint is a node. miniaudio engine uses a single endpoint.
     return (void*)ma_engine_get_endpoint(&g_engine);
 }
@@ -1054,18 +3267,7 @@ MA_BRIDGE_EXPORT void ma_bridge_sound_route_to_node(void* sound_handle, void* no
 }
 
 MA_BRIDGE_EXPORT void ma_bridge_deinit(void) {
-    ma_bridge_stop();
-
-    // Safety: Clear pointers to Dart memory BEFORE uninit.
-    g_fifo = NULL;
-    g_read_pos = NULL;
-    g_write_pos = NULL;
-
-    ma_bridge_uninit_resampler(); // Ensure resampler is cleaned up
-
-    if (g_device_initialized) {
-        ma_device_uninit(&g_device);
-        g_device_initialized = 0;
-    }
+    ma_bridge_stream_uninit(&g_stream); // Streams from ma_bridge_stream_create are left alone
     ma_bridge_engine_uninit();
+    ma_bridge_log_stop(); // After delivering what is queued; the next context or stream restarts it
 }
@@ -32,19 +32,35 @@ extern "C" {
  */
 MA_BRIDGE_EXPORT int ma_bridge_init(int sample_rate, int channels, int buffer_frames);
 
+#define MA_BRIDGE_CACHE_LINE_SIZE 64
+
+/**
+ * Shared FIFO positions (single producer, single consumer).
+ * Both counters are monotonically increasing sample counts and never wrap.
+ * The ring index is counter & (capacity - 1) when the capacity is a power
+ * of two, and counter % capacity otherwise. Each counter is padded to its
+ * own cache line so the producer and the audio thread never share a line.
+ * Only the bridge updates these; treat them as read-only from Dart.
+ */
+typedef struct ma_bridge_fifo_positions {
+    uint64_t write_pos; /* Samples written (producer, release) */
+    uint8_t pad0[MA_BRIDGE_CACHE_LINE_SIZE - sizeof(uint64_t)];
+    uint64_t read_pos;  /* Samples read (consumer, release) */
+    uint8_t pad1[MA_BRIDGE_CACHE_LINE_SIZE - sizeof(uint64_t)];
+} ma_bridge_fifo_positions;
+
 /**
  * Set the shared FIFO buffer for Dart ↔ Native communication.
  * Dart allocates memory and passes pointers here.
  * @param fifo_ptr       Pointer to FIFO buffer (int16_t samples, interleaved stereo)
- * @param capacity_samples Total capacity in samples (frames * channels)
- * @param read_pos       Pointer to read position (atomic, updated by native)
- * @param write_pos      Pointer to write position (atomic, updated by Dart)
+ * @param capacity_samples Total capacity in samples (frames * channels).
+ *                         Use a power of two to enable masked ring indexing.
+ * @param positions      Shared read/write counters (reset to 0 here)
  */
 MA_BRIDGE_EXPORT void ma_bridge_set_fifo(
     int16_t* fifo_ptr, 
     int capacity_samples, 
-    volatile int* read_pos, 
-    volatile int* write_pos
+    ma_bridge_fifo_positions* positions
 );
 
 /**
@@ -74,10 +90,110 @@ MA_BRIDGE_EXPORT int32_t ma_bridge_get_fifo_available(void);
 
 // Advanced Controls
 MA_BRIDGE_EXPORT void ma_bridge_set_volume(float volume); // 0.0 to 1.0 (or higher for gain)
-MA_BRIDGE_EXPORT void ma_bridge_set_log_enabled(int enabled);
+MA_BRIDGE_EXPORT void ma_bridge_set_log_enabled(int enabled); // Debug messages on/off (see Logging)
 MA_BRIDGE_EXPORT int32_t ma_bridge_get_device_sample_rate(void); // Get actual hardware sample rate
 MA_BRIDGE_EXPORT int32_t ma_bridge_get_device_channels(void); // Get actual hardware channels
 
+// --- Writing & Resampling ---
+
+/**
+ * Write interleaved frames straight into the shared FIFO (no resampling).
+ * @return Frames written (less than frameCount when the FIFO is full)
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_write_device_fifo(int16_t* data, int32_t frameCount);
+
+/**
+ * Reserve space in the FIFO so a producer can render straight into ring memory.
+ * The space is returned as up to two contiguous segments (the second is used
+ * when the reservation wraps). Nothing becomes audible until committed.
+ * @param frames Frames wanted
+ * @param ptr1   First segment (NULL if nothing reserved)
+ * @param len1   First segment length in frames
+ * @param ptr2   Second segment (NULL if the reservation does not wrap)
+ * @param len2   Second segment length in frames
+ * @return Frames reserved (len1 + len2), may be less than requested
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_fifo_reserve(int32_t frames, int16_t** ptr1, int32_t* len1, int16_t** ptr2, int32_t* len2);
+
+/**
+ * Publish frames written into a reservation (in order, starting at ptr1).
+ * @return Frames committed
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_fifo_commit(int32_t frames);
+
+/**
+ * Write frames through the resampler when one is active, else straight to the FIFO.
+ * @return Input frames consumed
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_write_pcm_frames(int16_t* data, int32_t frameCount);
+
+/**
+ * Block until the FIFO has room for `frames` frames (clamped to its capacity).
+ * Woken by the audio callback after every read; see ma_bridge_stream_wait_for_space.
+ * @return 0 when the space is available, -1 on timeout or when no FIFO is attached
+ */
+MA_BRIDGE_EXPORT int ma_bridge_wait_for_space(int32_t frames, uint64_t timeout_ns);
+
+/** Default-stream variant of ma_bridge_stream_set_low_water_notify. */
+MA_BRIDGE_EXPORT int ma_bridge_set_low_water_notify(void* post_cobject, int64_t port, int32_t watermark_frames);
+
+/**
+ * Block until the FIFO holds at most `frames` frames.
+ * @return 0 when the level is reached, -1 on timeout or when no FIFO is attached
+ */
+MA_BRIDGE_EXPORT int ma_bridge_wait_below_fill(int32_t frames, uint64_t timeout_ns);
+
+MA_BRIDGE_EXPORT int ma_bridge_init_resampler(int sourceSampleRate, int targetSampleRate);
+MA_BRIDGE_EXPORT void ma_bridge_uninit_resampler(void);
+MA_BRIDGE_EXPORT void ma_bridge_set_resample_quality(int quality);
+MA_BRIDGE_EXPORT void ma_bridge_set_resampling_ratio(float ratio); // input rate / output rate
+MA_BRIDGE_EXPORT void ma_bridge_set_playback_speed(float speed);
+MA_BRIDGE_EXPORT void ma_bridge_set_rate_control(int32_t target_latency_frames, float max_skew);
+
+// --- Backend Selection (Context) ---
+//
+// The shared context is created on first use by probing backends in order
+// until one initializes. By default that is every compiled-in backend in
+// miniaudio's priority order; unavailable servers (JACK, PulseAudio) can
+// stall that probe, so the order can be pinned before the first init.
+// Backends can also be left out of the build entirely with the
+// MINIAUDIO_FFI_BACKENDS CMake option.
+
+/**
+ * Backend ids (ma_backend values): 0 wasapi, 1 dsound, 2 winmm, 3 coreaudio,
+ * 4 sndio, 5 audio4, 6 oss, 7 pulseaudio, 8 alsa, 9 jack, 10 aaudio,
+ * 11 opensl, 12 webaudio, 13 custom, 14 null.
+ */
+
+/**
+ * Set the backends the context tries, in priority order. Must be called
+ * before anything initializes the context (enumeration, streams, engine).
+ * Backends that are not compiled in are skipped.
+ * @param backends Backend ids, or NULL to restore the default order
+ * @param count    Entries in backends
+ * @return Backends kept (0 = default order), or -1 if the context already exists
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_set_backends(const int32_t* backends, int32_t count);
+
+/** One backend attempt of the context init. */
+typedef struct {
+    int32_t backend;     /* ma_backend */
+    int32_t result;      /* ma_result, 0 = success (the backend in use) */
+    uint64_t elapsed_ns; /* Time spent initializing it */
+} ma_bridge_backend_probe;
+
+/**
+ * Copy the backend attempts of the context init, in the order they ran.
+ * @return Number of attempts (0 before the context exists)
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_backend_probes(ma_bridge_backend_probe* probes, int32_t capacity);
+
+/** Backend the context runs on, or -1 before it exists. */
+MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_backend(void);
+
+/** Human-readable name of a backend id ("ALSA", "PulseAudio", ...). */
+MA_BRIDGE_EXPORT const char* ma_bridge_get_backend_name(int32_t backend);
+
 // --- Device Enumeration (Context) ---
 
 /**
@@ -97,6 +213,42 @@ MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_device_count(int32_t type);
  */
 MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_device_info(int32_t type, int32_t index, char* name_buffer, int32_t name_len, void* id_buffer, int32_t id_len);
 
+#define MA_BRIDGE_DEVICE_NAME_LEN 256
+#define MA_BRIDGE_DEVICE_ID_LEN 256 /* sizeof(ma_device_id) */
+#define MA_BRIDGE_DEVICE_MAX_FORMATS 16
+
+/** One native data format of a device. 0 means "any" for each field. */
+typedef struct {
+    int32_t format; /* ma_format (ma_bridge_format values, or 1 = u8) */
+    int32_t channels;
+    int32_t sample_rate;
+    int32_t flags; /* MA_DATA_FORMAT_FLAG_* (2 = exclusive mode only) */
+} ma_bridge_device_format;
+
+/** A device as seen by the enumeration snapshot. */
+typedef struct {
+    char name[MA_BRIDGE_DEVICE_NAME_LEN]; /* utf8, NUL-terminated */
+    uint8_t id[MA_BRIDGE_DEVICE_ID_LEN]; /* ma_device_id, pass to the create calls */
+    int32_t is_default;
+    int32_t format_count; /* Entries used in formats (capped at MA_BRIDGE_DEVICE_MAX_FORMATS) */
+    ma_bridge_device_format formats[MA_BRIDGE_DEVICE_MAX_FORMATS];
+} ma_bridge_device_record;
+
+/**
+ * Copy the device list into a caller-provided array in one call.
+ * The backend is enumerated (and each device probed for its native formats)
+ * once; later calls, including get_device_count/get_device_info, are served
+ * from that snapshot until ma_bridge_context_invalidate_devices.
+ * @param type     0 = Playback, 1 = Capture.
+ * @param records  Array to fill (can be NULL to query the count)
+ * @param capacity Entries available in records
+ * @return Total number of devices (records filled: min(total, capacity)), or -1 on failure
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_devices(int32_t type, ma_bridge_device_record* records, int32_t capacity);
+
+/** Drop the cached device snapshot so the next enumeration call re-probes the backend (e.g. after a hot-plug). */
+MA_BRIDGE_EXPORT void ma_bridge_context_invalidate_devices(void);
+
 // --- Device API (Low Level) ---
 
 /**
@@ -105,8 +257,466 @@ MA_BRIDGE_EXPORT int32_t ma_bridge_context_get_device_info(int32_t type, int32_t
  */
 MA_BRIDGE_EXPORT int ma_bridge_init_with_device_id(void* device_id, int sample_rate, int channels, int buffer_frames);
 
+/**
+ * Native producer callback, run on the audio thread for every period.
+ * Render up to frame_count interleaved frames into output, in the stream's
+ * format and channel count. Must not block or allocate.
+ * @return Frames rendered; any shortfall is taken from the FIFO (if one is
+ *         attached), then filled with silence.
+ */
+typedef int32_t (*ma_bridge_render_proc)(void* user_data, void* output, int32_t frame_count);
+
+/**
+ * ma_bridge_init_with_device_id for native cores in the same process: the
+ * callback renders straight into the device buffer, skipping the FIFO's
+ * extra period of latency and copy. The FIFO stays usable as a fallback.
+ * @param render    Render callback (NULL behaves like ma_bridge_init_with_device_id)
+ * @param user_data Passed to every render call
+ */
+MA_BRIDGE_EXPORT int ma_bridge_init_with_render_callback(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_render_proc render, void* user_data);
+
 // ... (Existing start/stop/read/write/volume APIs for device remain) ...
 
+// --- Device Options ---
+//
+// Backend and performance settings applied to every device the bridge opens
+// afterwards: the default stream, new streams, and the engine at
+// ma_bridge_engine_init. Devices already open keep their settings.
+
+typedef struct {
+    int32_t periods;                       /* Backend buffer in periods; 0 = backend default. Sets the ALSA/PulseAudio buffer (period size * periods) */
+    int32_t conservative;                  /* 1 = ma_performance_profile_conservative, 0 = low latency */
+    int32_t no_pre_silenced_output_buffer; /* Skip miniaudio's memset of pOutput (the bridge writes every frame) */
+    int32_t no_clip;                       /* Skip miniaudio's clip pass on f32 output */
+    int32_t no_fixed_sized_callback;       /* Let the backend choose callback sizes, dropping miniaudio's intermediate buffer */
+    int32_t no_disable_denormals;          /* Leave the FPU denormal mode alone in the callback */
+    int32_t exclusive;                     /* Exclusive share mode where supported (WASAPI, AAudio) */
+    int32_t alsa_no_mmap;
+    int32_t alsa_no_auto_format;           /* SND_PCM_NO_AUTO_FORMAT: no plugin format conversion */
+    int32_t alsa_no_auto_channels;         /* SND_PCM_NO_AUTO_CHANNELS */
+    int32_t alsa_no_auto_resample;         /* SND_PCM_NO_AUTO_RESAMPLE: no plugin resampling */
+    int32_t aaudio_allow_set_buffer_capacity; /* Let AAudio size its buffer from periods */
+} ma_bridge_device_config;
+
+/** Fill a config with the defaults: low latency, no pre-silencing, everything else as miniaudio's defaults. */
+MA_BRIDGE_EXPORT void ma_bridge_device_config_init(ma_bridge_device_config* config);
+
+/**
+ * Set the options used for devices opened from now on. The engine always
+ * skips pre-silencing and clipping (it writes and clips every frame itself).
+ * @param config Options to copy, or NULL to restore the defaults
+ */
+MA_BRIDGE_EXPORT void ma_bridge_set_device_config(const ma_bridge_device_config* config);
+
+// --- Stream API (Multi-Instance) ---
+//
+// Each stream owns its own device, FIFO and resampler, so several players can
+// run side by side on one shared context. The ma_bridge_* device calls above
+// operate on a built-in default stream.
+
+typedef struct ma_bridge_stream ma_bridge_stream;
+
+/**
+ * FIFO sample format. Values match miniaudio's ma_format.
+ * The device always runs in its native format; the audio callback converts
+ * from the FIFO format while draining (SIMD for s16 <-> f32).
+ */
+typedef enum {
+    ma_bridge_format_s16 = 2,
+    ma_bridge_format_s24 = 3, /* Tightly packed, 3 bytes per sample */
+    ma_bridge_format_s32 = 4,
+    ma_bridge_format_f32 = 5
+} ma_bridge_format;
+
+/**
+ * Create and initialize a playback stream.
+ * @param device_id Pointer to ma_device_id (can be NULL for default).
+ * @param format    Sample format of the FIFO, writes and resampler.
+ * @return Stream handle, or NULL on failure.
+ */
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format);
+
+/**
+ * Create a stream fed by a native render callback (see ma_bridge_render_proc).
+ * The device is opened in `format`, so the callback writes it directly.
+ */
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_with_render_callback(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format, ma_bridge_render_proc render, void* user_data);
+
+/**
+ * Stop and uninit the stream, then free the handle.
+ * The FIFO memory set with ma_bridge_stream_set_fifo is not touched.
+ */
+MA_BRIDGE_EXPORT void ma_bridge_stream_destroy(ma_bridge_stream* stream);
+
+/** Stop and uninit the stream's device and resampler, keeping the handle. Both FIFOs are detached. */
+MA_BRIDGE_EXPORT void ma_bridge_stream_uninit(ma_bridge_stream* stream);
+
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_fifo(ma_bridge_stream* stream, void* fifo_ptr, int capacity_samples, ma_bridge_fifo_positions* positions);
+MA_BRIDGE_EXPORT int ma_bridge_stream_start(ma_bridge_stream* stream);
+MA_BRIDGE_EXPORT int ma_bridge_stream_stop(ma_bridge_stream* stream);
+MA_BRIDGE_EXPORT uint64_t ma_bridge_stream_get_frames_consumed(ma_bridge_stream* stream);
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_fifo_available(ma_bridge_stream* stream);
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_volume(ma_bridge_stream* stream, float volume);
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_device_sample_rate(ma_bridge_stream* stream);
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_device_channels(ma_bridge_stream* stream);
+
+// Sample pointers below are in the stream's FIFO format
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_write_device_fifo(ma_bridge_stream* stream, const void* data, int32_t frameCount);
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_fifo_reserve(ma_bridge_stream* stream, int32_t frames, void** ptr1, int32_t* len1, void** ptr2, int32_t* len2);
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_fifo_commit(ma_bridge_stream* stream, int32_t frames);
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_write_pcm_frames(ma_bridge_stream* stream, const void* data, int32_t frameCount);
+
+/** @return 0 on success, -1 on failure (also when the FIFO format is not s16 or f32) */
+MA_BRIDGE_EXPORT int ma_bridge_stream_init_resampler(ma_bridge_stream* stream, int sourceSampleRate, int targetSampleRate);
+MA_BRIDGE_EXPORT void ma_bridge_stream_uninit_resampler(ma_bridge_stream* stream);
+
+/**
+ * Select the resampler used by the next init_resampler / init_pull_resampler.
+ * @param quality 0 = linear (default), 1 = sinc low (8 taps), 2 = sinc medium (16 taps),
+ *                3 = sinc high (32 taps). The sinc modes are band-limited (no aliasing
+ *                on downsampling) at the cost of taps/2 input frames of latency.
+ */
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_resample_quality(ma_bridge_stream* stream, int quality);
+
+/**
+ * Set the nominal resampling ratio (input rate / output rate). Defaults to
+ * source / target rate from init_resampler. Rate control and playback speed
+ * are applied on top of it, so it is never overwritten by a write.
+ */
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_resampling_ratio(ma_bridge_stream* stream, float ratio);
+
+/**
+ * Playback speed factor (1.0 = normal), independent of rate control.
+ * These rate settings can be called from any thread while the stream runs;
+ * they take effect at the next write (push) or audio period (pull).
+ */
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_playback_speed(ma_bridge_stream* stream, float speed);
+
+/**
+ * Configure dynamic rate control. On each write (each audio period with the
+ * pull resampler) the smoothed FIFO fill is fed to a PI controller that
+ * skews the ratio by at most +-max_skew (a fraction, e.g. 0.005) to hold the
+ * fill at the target. Needs an active resampler: ma_bridge_stream_init_resampler
+ * skips matching rates, so with equal source and device rates this (like the
+ * playback speed) has no effect.
+ * @param target_latency_frames Fill to hold, in frames; <= 0 = half the FIFO (default)
+ * @param max_skew              Correction limit; <= 0 disables rate control. Default 0.005.
+ */
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_rate_control(ma_bridge_stream* stream, int32_t target_latency_frames, float max_skew);
+
+/** Ratio applied to the most recent write or pull period (nominal * speed * correction). */
+MA_BRIDGE_EXPORT float ma_bridge_stream_get_resampling_ratio(ma_bridge_stream* stream);
+
+/**
+ * Resample in the audio callback instead of on write. The FIFO then holds
+ * source-rate audio, written as-is (no work on the producer thread), and rate
+ * control re-steers every period from the measured fill. Replaces any
+ * init_resampler setup. Call after the device is initialized, while stopped.
+ * Speed, ratio and rate control settings apply as in write mode.
+ * @param sourceSampleRate Producer rate; <= 0 switches back to plain FIFO playback
+ * @return 0 on success, -1 on failure or if the stream is running
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_init_pull_resampler(ma_bridge_stream* stream, int sourceSampleRate);
+
+// --- Stream Telemetry ---
+
+#define MA_BRIDGE_STREAM_STATS_VERSION 1
+
+/**
+ * Glitch counters, updated lock-free and readable straight from shared memory.
+ * All counters are 64-bit, monotonic and never reset; diff two snapshots to
+ * get rates.
+ *
+ * The block is two cache lines, and the bridge keeps it cache-line aligned.
+ * The first line is written only by the audio thread under a seqlock: read
+ * `sequence` (ma_bridge_stream_stats_sequence), skip if odd, read the fields,
+ * then re-read `sequence` the same way and retry if it changed. This keeps
+ * 64-bit reads consistent on 32-bit targets. The second line is written only
+ * by the producer (the thread calling the write/reserve functions).
+ */
+typedef struct ma_bridge_stream_stats {
+    uint32_t version;          /* MA_BRIDGE_STREAM_STATS_VERSION */
+    uint32_t size;             /* sizeof(ma_bridge_stream_stats) */
+    uint32_t sequence;         /* Seqlock, odd while the audio thread is updating */
+    uint32_t reset_requested;  /* Set by ma_bridge_stream_reset_stats, cleared by the audio thread */
+
+    /* Audio thread */
+    uint64_t frames_consumed;  /* Frames taken from the FIFO */
+    uint64_t callback_count;
+    uint64_t underrun_events;  /* Callbacks that had to zero-fill */
+    uint64_t underrun_frames;  /* Frames zero-filled */
+    uint64_t fill_min_frames;  /* FIFO fill at callback entry, since the last reset */
+    uint64_t fill_max_frames;
+
+    /* Producer */
+    uint64_t overrun_events;   /* Writes/reservations cut short by a full FIFO */
+    uint64_t overrun_frames;   /* Frames not accepted by those calls */
+    uint8_t pad[MA_BRIDGE_CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];
+} ma_bridge_stream_stats;
+
+/**
+ * Get the stream's stats block. The pointer stays valid until the stream is
+ * destroyed, so it can be mapped once and polled without further calls.
+ */
+MA_BRIDGE_EXPORT const ma_bridge_stream_stats* ma_bridge_stream_get_stats(ma_bridge_stream* stream);
+
+/** Restart min/max fill tracking (applied by the audio thread on its next callback). */
+MA_BRIDGE_EXPORT void ma_bridge_stream_reset_stats(ma_bridge_stream* stream);
+
+/**
+ * Load `stats->sequence` with the ordering a seqlock reader needs: fields
+ * read after the call are not read before it, and fields read before it are
+ * not read after. For readers (like Dart) that cannot issue fences themselves.
+ */
+MA_BRIDGE_EXPORT uint32_t ma_bridge_stream_stats_sequence(const ma_bridge_stream_stats* stats);
+
+// --- Callback Timing Trace ---
+
+#define MA_BRIDGE_TRACE_CAPACITY 1024 /* Records buffered per stream between drains */
+#define MA_BRIDGE_JITTER_BINS 16
+
+/** Monotonic host clock in nanoseconds (same clock as the trace timestamps). */
+MA_BRIDGE_EXPORT uint64_t ma_bridge_now_ns(void);
+
+/** One audio callback, recorded at entry and exit of the device callback. */
+typedef struct ma_bridge_callback_trace {
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint32_t frames_requested;
+    uint32_t frames_delivered; /* From the FIFO; the rest was zero-filled */
+} ma_bridge_callback_trace;
+
+/**
+ * Aggregate over every drained trace record since the last reset.
+ * Interval error is (start - previous start) - previous period, where a
+ * period is frames_requested / sample_rate. jitter_histogram[0] counts
+ * |error| < 1 us, bin i counts [2^(i-1), 2^i) us, and the last bin is open-ended.
+ * Load is callback duration / period (1.0 = the whole period was spent in the callback).
+ */
+typedef struct ma_bridge_trace_summary {
+    uint64_t callbacks;
+    uint64_t dropped;           /* Records lost because the trace was not drained in time */
+    double load_mean;
+    double load_max;
+    int64_t interval_error_min_ns;
+    int64_t interval_error_max_ns;
+    uint64_t jitter_histogram[MA_BRIDGE_JITTER_BINS];
+} ma_bridge_trace_summary;
+
+/** Enable or disable callback tracing (off by default). */
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_trace_enabled(ma_bridge_stream* stream, int enabled);
+
+/**
+ * Drain pending trace records and fold them into the summary. Call from one
+ * non-realtime thread.
+ * @param out  Receives the drained records (can be NULL to only update the summary)
+ * @param max  Capacity of out; ignored when out is NULL (everything is drained)
+ * @return Records drained
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_drain_trace(ma_bridge_stream* stream, ma_bridge_callback_trace* out, int32_t max);
+
+/** Copy the current summary (does not drain; call ma_bridge_stream_drain_trace first). */
+MA_BRIDGE_EXPORT void ma_bridge_stream_get_trace_summary(ma_bridge_stream* stream, ma_bridge_trace_summary* out);
+
+MA_BRIDGE_EXPORT void ma_bridge_stream_reset_trace_summary(ma_bridge_stream* stream);
+
+// --- Playback Timestamp (A/V Sync) ---
+
+/**
+ * Get the playback clock captured at entry of the most recent audio callback.
+ * The pair is published atomically, so both values belong to the same callback.
+ * The frame at frame_position becomes audible at about
+ * host_time_ns + output latency; extrapolate with the device sample rate.
+ * @param frame_position FIFO frames consumed before that callback (content position)
+ * @param host_time_ns   ma_bridge_now_ns() at callback entry
+ * @return 0 on success, -1 if no callback has run yet
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_get_timestamp(ma_bridge_stream* stream, uint64_t* frame_position, uint64_t* host_time_ns);
+
+/**
+ * Output latency in frames (device sample rate): the backend's internal
+ * buffer (period size * periods) plus any miniaudio conversion delay.
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_output_latency_frames(ma_bridge_stream* stream);
+
+// --- Blocking Waits ---
+
+/**
+ * Block the calling (producer) thread until the FIFO has room for `frames`
+ * frames, instead of polling with sleep(). The audio callback wakes waiters
+ * after each read; it never blocks and skips the wake when nobody waits.
+ * Returns early with -1 if the stream is stopped or its FIFO detached.
+ * Do not destroy the stream while another thread is waiting on it.
+ * @param frames     Free frames wanted (clamped to the FIFO capacity)
+ * @param timeout_ns Maximum wait; 0 checks once without blocking
+ * @return 0 when the space is available, -1 on timeout or when no FIFO is attached
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_wait_for_space(ma_bridge_stream* stream, int32_t frames, uint64_t timeout_ns);
+
+/**
+ * Block until the FIFO holds at most `frames` frames (a target buffer level).
+ * @return 0 when the level is reached, -1 on timeout or when no FIFO is attached
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_wait_below_fill(ma_bridge_stream* stream, int32_t frames, uint64_t timeout_ns);
+
+// --- Low-Water Notification ---
+
+/**
+ * Post an event to a Dart port whenever the FIFO fill drops below
+ * `watermark_frames` (edge-triggered; re-armed once the fill is back at the
+ * watermark). The message is an int: the fill in frames at the crossing.
+ * The audio callback only raises a flag; a dedicated handoff thread makes
+ * the Dart_PostCObject call. Replaces any previous registration; stream
+ * uninit/re-init clears it.
+ * @param post_cobject     Dart_PostCObject (NativeApi.postCObject from Dart); NULL disables
+ * @param port             Native port of the receiving SendPort; 0 disables
+ * @param watermark_frames Threshold in frames; <= 0 disables
+ * @return 0 on success, -1 if the handoff thread could not be started
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_set_low_water_notify(ma_bridge_stream* stream, void* post_cobject, int64_t port, int32_t watermark_frames);
+
+// --- Capture Streams ---
+//
+// Capture mirrors playback with the roles swapped: the audio callback is the
+// producer of a shared SPSC FIFO (converting from the device's native format
+// into the stream format) and the reader drains it, zero-copy through
+// capture_acquire / capture_release or with a copy through read_capture.
+// Start, stop, destroy, tracing and volume use the regular stream calls.
+
+/**
+ * Create and initialize a capture stream.
+ * @param device_id Pointer to ma_device_id of a capture device (can be NULL for default).
+ * @param format    Sample format of the capture FIFO.
+ * @return Stream handle, or NULL on failure.
+ */
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_capture(void* device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format);
+
+/**
+ * Set the shared capture FIFO (same layout rules as ma_bridge_stream_set_fifo).
+ * Frames captured before it is set are discarded.
+ */
+MA_BRIDGE_EXPORT void ma_bridge_stream_set_capture_fifo(ma_bridge_stream* stream, void* fifo_ptr, int capacity_samples, ma_bridge_fifo_positions* positions);
+
+/** Captured samples waiting in the FIFO. */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_capture_fifo_available(ma_bridge_stream* stream);
+
+/**
+ * Expose up to `frames` captured frames in place, as up to two contiguous
+ * segments of ring memory (the second is used when the data wraps). The
+ * callback does not overwrite them until they are released.
+ * @return Frames acquired (len1 + len2)
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_capture_acquire(ma_bridge_stream* stream, int32_t frames, void** ptr1, int32_t* len1, void** ptr2, int32_t* len2);
+
+/**
+ * Hand frames obtained through capture_acquire back to the callback (in order).
+ * @return Frames released
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_capture_release(ma_bridge_stream* stream, int32_t frames);
+
+/**
+ * Copy up to `frameCount` captured frames out of the FIFO (stream format).
+ * @return Frames read
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_read_capture(ma_bridge_stream* stream, void* data, int32_t frameCount);
+
+/**
+ * Block until the capture FIFO holds at least `frames` frames (clamped to its
+ * capacity). Woken by the audio callback; same rules as wait_for_space.
+ * @return 0 when the data is available, -1 on timeout or when no FIFO is attached
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_wait_for_capture(ma_bridge_stream* stream, int32_t frames, uint64_t timeout_ns);
+
+/**
+ * Capture counterpart of ma_bridge_stream_get_stats (reset with
+ * ma_bridge_stream_reset_stats). Here the audio thread writes both lines:
+ * frames_consumed counts frames stored in the FIFO, overrun_* count frames
+ * dropped because the reader fell behind, fill_* is the capture fill at
+ * callback entry, and underrun_* stay 0.
+ */
+MA_BRIDGE_EXPORT const ma_bridge_stream_stats* ma_bridge_stream_get_capture_stats(ma_bridge_stream* stream);
+
+/**
+ * Get the capture clock captured at entry of the most recent audio callback.
+ * The frame at frame_position (FIFO frames stored before that callback) was
+ * recorded at about host_time_ns - input latency.
+ * @return 0 on success, -1 if no capture callback has run yet
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_get_capture_timestamp(ma_bridge_stream* stream, uint64_t* frame_position, uint64_t* host_time_ns);
+
+/** Input latency in frames (device sample rate): one backend period plus any miniaudio conversion delay. */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_get_input_latency_frames(ma_bridge_stream* stream);
+
+// --- Duplex Streams ---
+//
+// One device with both directions on a shared period: every callback gets
+// this period's input and output buffers together, so input can be turned
+// into output within the same callback (monitoring, effects, echo
+// cancellation) with a round trip of input latency + output latency.
+// Duplex streams carry both FIFOs: set_fifo/write/reserve feed the output,
+// the capture calls above drain the input.
+
+/**
+ * Native duplex callback, run on the audio thread for every period after the
+ * input has been stored in the capture FIFO. `input` and `output` hold
+ * frame_count interleaved frames in the stream's format and channel count.
+ * Must not block or allocate.
+ * @return Frames written to output; any shortfall is taken from the playback
+ *         FIFO (if one is attached), then filled with silence.
+ */
+typedef int32_t (*ma_bridge_duplex_proc)(void* user_data, const void* input, void* output, int32_t frame_count);
+
+/**
+ * Create and initialize a duplex stream.
+ * With a callback both sides are opened in `format` so it reads and writes
+ * them directly; without one each side runs in its native format and only
+ * the FIFOs are used.
+ * @param playback_device_id Pointer to ma_device_id of the output (can be NULL for default).
+ * @param capture_device_id  Pointer to ma_device_id of the input (can be NULL for default).
+ * @param process            Duplex callback, or NULL
+ * @param user_data          Passed to every process call
+ * @return Stream handle, or NULL on failure.
+ */
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_duplex(void* playback_device_id, void* capture_device_id, int sample_rate, int channels, int buffer_frames, ma_bridge_format format, ma_bridge_duplex_proc process, void* user_data);
+
+// --- Offline Streams ---
+//
+// A playback stream without a device, for headless runs and tests. Periods
+// go through the same callback path as a device stream (FIFO, rate control,
+// resampler, stats, trace) but are timestamped on a virtual clock that
+// advances by exactly buffer_frames per period. start() runs a pump thread,
+// as fast as possible or paced to a multiple of real time; pump() runs
+// periods synchronously on the calling thread. With the same seed, input
+// and clock settings every run produces the same output.
+
+/**
+ * Create an offline playback stream.
+ * @param device_format Format of the simulated device (ma_bridge_format
+ *                      values, or 1 = u8); 0 means the same as `format`.
+ * @return Stream handle, or NULL on failure.
+ */
+MA_BRIDGE_EXPORT ma_bridge_stream* ma_bridge_stream_create_offline(int sample_rate, int channels, int buffer_frames, ma_bridge_format format, ma_bridge_format device_format);
+
+/**
+ * Configure the virtual clock of an offline stream. Only while stopped.
+ * @param speed     Virtual seconds per real second for the pump thread;
+ *                  0 or less runs as fast as possible. pump() ignores it.
+ * @param jitter_us Maximum +/- offset applied to each period's timestamp,
+ *                  clamped to half a period.
+ * @param seed      Seed of the jitter sequence (0 is treated as 1).
+ * @return 0 on success, -1 if not an offline stream or running.
+ */
+MA_BRIDGE_EXPORT int ma_bridge_stream_set_offline_clock(ma_bridge_stream* stream, float speed, int32_t jitter_us, uint32_t seed);
+
+/**
+ * Run periods of an offline stream on the calling thread, back to back.
+ * @param output periods * buffer_frames frames in the device format, or NULL
+ *               to discard the rendered audio.
+ * @return Frames taken from the FIFO (the rest is silence), or -1 if not an
+ *         offline stream or the pump thread runs.
+ */
+MA_BRIDGE_EXPORT int32_t ma_bridge_stream_pump(ma_bridge_stream* stream, int32_t periods, void* output);
+
 // --- Engine API (High Level) ---
 
 /**
@@ -264,6 +874,87 @@ MA_BRIDGE_EXPORT void ma_bridge_node_uninit(void* node_handle);
  */
 MA_BRIDGE_EXPORT void ma_bridge_sound_route_to_node(void* sound_handle, void* node_handle);
 
+// --- Logging ---
+//
+// Bridge messages go through a bounded lock-free queue as a format string
+// plus raw arguments; a background thread formats and delivers them in order.
+// Logging therefore never formats, locks or allocates on the caller (audio
+// callbacks included). When the queue is full a message is dropped and
+// counted; the drain thread then reports the loss as a warning.
+//
+// The thread starts with the first context, stream or sink and is joined by
+// ma_bridge_deinit after it delivers what is queued. Sink setters take effect
+// between messages and may briefly wait for one in delivery; call them from
+// a control thread, never from a sink (nor ma_bridge_log_flush).
+
+typedef enum {
+    ma_bridge_log_level_debug = 0,
+    ma_bridge_log_level_info = 1,    /* Default minimum */
+    ma_bridge_log_level_warning = 2,
+    ma_bridge_log_level_error = 3,
+    ma_bridge_log_level_none = 4     /* As a minimum: record nothing */
+} ma_bridge_log_level;
+
+/** Receives each message on the log thread. `message` is valid for the call only. */
+typedef void (*ma_bridge_log_proc)(void* user_data, int32_t level, uint64_t time_ns, const char* message);
+
+/** Minimum level recorded. ma_bridge_set_log_enabled(1/0) selects debug/info. */
+MA_BRIDGE_EXPORT void ma_bridge_log_set_level(int32_t level);
+
+/** Print delivered messages to stdout (default on). */
+MA_BRIDGE_EXPORT void ma_bridge_log_set_stdout(int32_t enabled);
+
+/** Deliver messages to `proc` as well; NULL removes it. */
+MA_BRIDGE_EXPORT void ma_bridge_log_set_callback(ma_bridge_log_proc proc, void* user_data);
+
+/**
+ * Post messages to a Dart port as well, as [level, time_ns, message].
+ * @param post_cobject Dart_PostCObject (NativeApi.postCObject from Dart); NULL disables
+ * @param port         Native port of the receiving SendPort
+ */
+MA_BRIDGE_EXPORT void ma_bridge_log_set_port(void* post_cobject, int64_t port);
+
+/** @return Messages dropped because the queue was full, since process start. */
+MA_BRIDGE_EXPORT uint64_t ma_bridge_log_get_dropped(void);
+
+/** Deliver everything queued so far on the calling thread, in order with the log thread. */
+MA_BRIDGE_EXPORT void ma_bridge_log_flush(void);
+
+// --- Real-Time Safety Audit ---
+//
+// Debug builds with -DMINIAUDIO_FFI_RT_AUDIT=ON (GNU linkers: Linux,
+// Android) trap heap allocation, mutex waits and printf-family calls made
+// by the bridge or miniaudio on an audio thread: inside a stream callback
+// (offline pumps included) or while the engine renders its node graph.
+// Other builds keep these entry points and return -1.
+
+typedef enum {
+    ma_bridge_rt_audit_mode_off = 0,
+    ma_bridge_rt_audit_mode_report = 1, /* Count, and print the first few to stderr (default) */
+    ma_bridge_rt_audit_mode_abort = 2   /* Print and abort() on the first violation */
+} ma_bridge_rt_audit_mode;
+
+typedef struct ma_bridge_rt_audit_report {
+    uint64_t allocations;  /* malloc / calloc / realloc / free */
+    uint64_t locks;        /* pthread_mutex_lock / pthread_cond_wait */
+    uint64_t prints;       /* printf / fprintf / puts / ... */
+    char last_call[32];    /* Wrapped function of the latest violation */
+    char last_site[32];    /* Audio-thread section it was made from */
+} ma_bridge_rt_audit_report;
+
+/**
+ * Select what a violation does. The MA_BRIDGE_RT_AUDIT environment variable
+ * ("off", "report" or "abort") sets the initial mode.
+ * @return 0 on success, -1 if the audit is not compiled in.
+ */
+MA_BRIDGE_EXPORT int ma_bridge_rt_audit_set_mode(ma_bridge_rt_audit_mode mode);
+
+/** @return 0 on success, -1 if the audit is not compiled in (out is zeroed). */
+MA_BRIDGE_EXPORT int ma_bridge_rt_audit_get_report(ma_bridge_rt_audit_report* out);
+
+MA_BRIDGE_EXPORT void ma_bridge_rt_audit_reset(void);
+
+/** Uninit the default stream and the engine. Streams from ma_bridge_stream_create are not affected. */
 MA_BRIDGE_EXPORT void ma_bridge_deinit(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,259 @@
+/*
+ * miniaudio_bridge_rt_audit.c - Real-time safety audit for the bridge
+ *
+ * The bridge and miniaudio objects are linked with --wrap=<symbol> for the
+ * calls below, so each of their references lands in a __wrap_ function
+ * here that checks the thread's real-time mark before forwarding to the
+ * real one. Calls made by other libraries (libc internals, the Dart VM)
+ * are not affected. Counters and the latest call/site are process-wide;
+ * the mark is per thread.
+ */
+
+#include "miniaudio_bridge.h"
+#include "miniaudio_bridge_rt_audit.h"
+
+#include <string.h>
+
+#ifdef MA_BRIDGE_RT_AUDIT
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define MA_BRIDGE_RT_AUDIT_PRINT_LIMIT 16 /* Report mode prints this many, then only counts */
+
+typedef enum {
+    rt_audit_allocation,
+    rt_audit_lock,
+    rt_audit_print
+} rt_audit_kind;
+
+static __thread int t_depth;
+static __thread const char* t_site;
+static __thread int t_reporting; /* A report in progress must not report itself */
+
+static int g_mode = -1; /* -1 until read from the environment */
+static uint64_t g_counts[3];
+static uint64_t g_printed;
+static const char* g_last_call;
+static const char* g_last_site;
+
+static int rt_audit_mode(void) {
+    int mode = __atomic_load_n(&g_mode, __ATOMIC_RELAXED);
+    if (mode >= 0) return mode;
+
+    const char* env = getenv("MA_BRIDGE_RT_AUDIT");
+    mode = ma_bridge_rt_audit_mode_report;
+    if (env && strcmp(env, "off") == 0) mode = ma_bridge_rt_audit_mode_off;
+    if (env && strcmp(env, "abort") == 0) mode = ma_bridge_rt_audit_mode_abort;
+
+    int expected = -1;
+    __atomic_compare_exchange_n(&g_mode, &expected, mode, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    return __atomic_load_n(&g_mode, __ATOMIC_RELAXED);
+}
+
+/* write(2) only: stdio is one of the things being trapped */
+static void rt_audit_write(const char* text) {
+    ssize_t result = write(STDERR_FILENO, text, strlen(text));
+    (void)result;
+}
+
+static void rt_audit_violation(rt_audit_kind kind, const char* call) {
+    if (t_depth == 0 || t_reporting) return;
+    int mode = rt_audit_mode();
+    if (mode == ma_bridge_rt_audit_mode_off) return;
+
+    t_reporting = 1;
+    __atomic_fetch_add(&g_counts[kind], 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_last_call, call, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_last_site, t_site, __ATOMIC_RELAXED);
+
+    if (mode == ma_bridge_rt_audit_mode_abort || __atomic_fetch_add(&g_printed, 1, __ATOMIC_RELAXED) < MA_BRIDGE_RT_AUDIT_PRINT_LIMIT) {
+        rt_audit_write("[miniaudio_bridge] RT audit: ");
+        rt_audit_write(call);
+        rt_audit_write(" in ");
+        rt_audit_write(t_site ? t_site : "audio thread");
+        rt_audit_write("\n");
+    }
+    if (mode == ma_bridge_rt_audit_mode_abort) abort();
+    t_reporting = 0;
+}
+
+void ma_bridge_rt_audit_enter(const char* site) {
+    if (t_depth++ == 0) t_site = site;
+}
+
+void ma_bridge_rt_audit_leave(void) {
+    if (t_depth > 0) t_depth--;
+}
+
+/* --- Wrapped Calls --- */
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+int __real_pthread_mutex_lock(pthread_mutex_t* mutex);
+int __real_pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex);
+int __real_vfprintf(FILE* stream, const char* format, va_list args);
+int __real_fputs(const char* text, FILE* stream);
+int __real_puts(const char* text);
+int __real_putchar(int c);
+size_t __real_fwrite(const void* data, size_t size, size_t count, FILE* stream);
+
+void* __wrap_malloc(size_t size) {
+    rt_audit_violation(rt_audit_allocation, "malloc");
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    rt_audit_violation(rt_audit_allocation, "calloc");
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    rt_audit_violation(rt_audit_allocation, "realloc");
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void* ptr) {
+    if (ptr) rt_audit_violation(rt_audit_allocation, "free");
+    __real_free(ptr);
+}
+
+int __wrap_pthread_mutex_lock(pthread_mutex_t* mutex) {
+    rt_audit_violation(rt_audit_lock, "pthread_mutex_lock");
+    return __real_pthread_mutex_lock(mutex);
+}
+
+int __wrap_pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex) {
+    rt_audit_violation(rt_audit_lock, "pthread_cond_wait");
+    return __real_pthread_cond_wait(cond, mutex);
+}
+
+int __wrap_vfprintf(FILE* stream, const char* format, va_list args) {
+    rt_audit_violation(rt_audit_print, "vfprintf");
+    return __real_vfprintf(stream, format, args);
+}
+
+int __wrap_vprintf(const char* format, va_list args) {
+    rt_audit_violation(rt_audit_print, "vprintf");
+    return __real_vfprintf(stdout, format, args);
+}
+
+int __wrap_printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    rt_audit_violation(rt_audit_print, "printf");
+    int result = __real_vfprintf(stdout, format, args);
+    va_end(args);
+    return result;
+}
+
+int __wrap_fprintf(FILE* stream, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    rt_audit_violation(rt_audit_print, "fprintf");
+    int result = __real_vfprintf(stream, format, args);
+    va_end(args);
+    return result;
+}
+
+// Fortified builds (_FORTIFY_SOURCE) call the __*_chk variants instead; the
+// check flag is dropped since the format is forwarded unchanged.
+int __wrap___printf_chk(int flag, const char* format, ...) {
+    va_list args;
+    (void)flag;
+    va_start(args, format);
+    rt_audit_violation(rt_audit_print, "printf");
+    int result = __real_vfprintf(stdout, format, args);
+    va_end(args);
+    return result;
+}
+
+int __wrap___fprintf_chk(FILE* stream, int flag, const char* format, ...) {
+    va_list args;
+    (void)flag;
+    va_start(args, format);
+    rt_audit_violation(rt_audit_print, "fprintf");
+    int result = __real_vfprintf(stream, format, args);
+    va_end(args);
+    return result;
+}
+
+int __wrap___vfprintf_chk(FILE* stream, int flag, const char* format, va_list args) {
+    (void)flag;
+    rt_audit_violation(rt_audit_print, "vfprintf");
+    return __real_vfprintf(stream, format, args);
+}
+
+int __wrap_fputs(const char* text, FILE* stream) {
+    rt_audit_violation(rt_audit_print, "fputs");
+    return __real_fputs(text, stream);
+}
+
+int __wrap_puts(const char* text) {
+    rt_audit_violation(rt_audit_print, "puts");
+    return __real_puts(text);
+}
+
+int __wrap_putchar(int c) {
+    rt_audit_violation(rt_audit_print, "putchar");
+    return __real_putchar(c);
+}
+
+size_t __wrap_fwrite(const void* data, size_t size, size_t count, FILE* stream) {
+    rt_audit_violation(rt_audit_print, "fwrite");
+    return __real_fwrite(data, size, count, stream);
+}
+
+/* --- Exports --- */
+
+static void rt_audit_copy_name(char* dst, size_t size, const char* src) {
+    size_t length = src ? strlen(src) : 0;
+    if (length >= size) length = size - 1;
+    if (length) memcpy(dst, src, length);
+    dst[length] = '\0';
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_rt_audit_set_mode(ma_bridge_rt_audit_mode mode) {
+    if (mode < ma_bridge_rt_audit_mode_off || mode > ma_bridge_rt_audit_mode_abort) return -1;
+    __atomic_store_n(&g_mode, (int)mode, __ATOMIC_RELAXED);
+    return 0;
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_rt_audit_get_report(ma_bridge_rt_audit_report* out) {
+    if (!out) return -1;
+    out->allocations = __atomic_load_n(&g_counts[rt_audit_allocation], __ATOMIC_RELAXED);
+    out->locks = __atomic_load_n(&g_counts[rt_audit_lock], __ATOMIC_RELAXED);
+    out->prints = __atomic_load_n(&g_counts[rt_audit_print], __ATOMIC_RELAXED);
+    rt_audit_copy_name(out->last_call, sizeof(out->last_call), __atomic_load_n(&g_last_call, __ATOMIC_RELAXED));
+    rt_audit_copy_name(out->last_site, sizeof(out->last_site), __atomic_load_n(&g_last_site, __ATOMIC_RELAXED));
+    return 0;
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_rt_audit_reset(void) {
+    for (int i = 0; i < 3; i++) __atomic_store_n(&g_counts[i], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_printed, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_last_call, NULL, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_last_site, NULL, __ATOMIC_RELAXED);
+}
+
+#else /* !MA_BRIDGE_RT_AUDIT */
+
+MA_BRIDGE_EXPORT int ma_bridge_rt_audit_set_mode(ma_bridge_rt_audit_mode mode) {
+    (void)mode;
+    return -1;
+}
+
+MA_BRIDGE_EXPORT int ma_bridge_rt_audit_get_report(ma_bridge_rt_audit_report* out) {
+    if (out) memset(out, 0, sizeof(*out));
+    return -1;
+}
+
+MA_BRIDGE_EXPORT void ma_bridge_rt_audit_reset(void) {
+}
+
+#endif /* MA_BRIDGE_RT_AUDIT */
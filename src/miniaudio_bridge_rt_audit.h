@@ -0,0 +1,34 @@
+/*
+ * miniaudio_bridge_rt_audit.h - Real-time safety audit for the bridge
+ *
+ * Debug builds configured with -DMINIAUDIO_FFI_RT_AUDIT=ON define
+ * MA_BRIDGE_RT_AUDIT and link the bridge with its allocator, mutex and
+ * stdio calls wrapped (GNU ld --wrap). The audio callbacks mark their
+ * thread while they run; a wrapped call made while marked is counted and
+ * reported, or aborts the process. Other builds compile the marks away.
+ */
+
+#ifndef MINIAUDIO_BRIDGE_RT_AUDIT_H
+#define MINIAUDIO_BRIDGE_RT_AUDIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef MA_BRIDGE_RT_AUDIT
+/** Mark the calling thread as real-time until the matching leave. Nests. */
+void ma_bridge_rt_audit_enter(const char* site);
+void ma_bridge_rt_audit_leave(void);
+
+#define MA_BRIDGE_RT_ENTER(site) ma_bridge_rt_audit_enter(site)
+#define MA_BRIDGE_RT_LEAVE()     ma_bridge_rt_audit_leave()
+#else
+#define MA_BRIDGE_RT_ENTER(site) ((void)0)
+#define MA_BRIDGE_RT_LEAVE()     ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINIAUDIO_BRIDGE_RT_AUDIT_H */
@@ -0,0 +1,499 @@
+/*
+ * miniaudio_bridge_sinc.c - Polyphase sinc resampler for the bridge
+ *
+ * Each output frame is a dot product of the last `taps` input frames with a
+ * Kaiser-windowed sinc, evaluated at the fractional read position. The filter
+ * is precomputed for `phases` + 1 evenly spaced positions; coefficients for
+ * the exact position are linearly blended from the two nearest phases, so any
+ * ratio (including one that changes every block) is exact to within that
+ * interpolation. History is kept planar per channel and mirrored, so every
+ * window is contiguous and the inner loops are plain SIMD dot products.
+ */
+
+#include "miniaudio_bridge_sinc.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || ((defined(__i386__) || defined(_M_IX86)) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+    #define MA_BRIDGE_SINC_SSE2
+    #include <emmintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define MA_BRIDGE_SINC_AVX2
+        #include <immintrin.h>
+        #include <intrin.h>
+    #elif defined(__GNUC__) || defined(__clang__)
+        #define MA_BRIDGE_SINC_AVX2
+        #include <immintrin.h>
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define MA_BRIDGE_SINC_NEON
+    #include <arm_neon.h>
+#endif
+
+#define MA_BRIDGE_SINC_ALIGN 32
+#define MA_BRIDGE_SINC_REBUILD_TOLERANCE 0.02 /* Re-derive the table when the cutoff moves more than 2% */
+
+typedef struct {
+    ma_uint32 taps;    /* Multiple of 8 */
+    ma_uint32 phases;
+    double beta;       /* Kaiser window shape: stopband attenuation */
+    double rolloff;    /* Passband edge as a fraction of the lower Nyquist */
+} ma_bridge_sinc_quality_params;
+
+static const ma_bridge_sinc_quality_params g_sinc_quality[] = {
+    {  8,  64,  6.0, 0.80 },  /* low */
+    { 16, 128,  8.0, 0.88 },  /* medium */
+    { 32, 256, 10.0, 0.93 }   /* high */
+};
+
+/* --- Kernels --- */
+
+typedef void  (*ma_bridge_sinc_blend_proc)(float* pOut, const float* pCoeffs, const float* pDeltas, float frac, ma_uint32 taps);
+typedef float (*ma_bridge_sinc_dot_proc)(const float* pWindow, const float* pCoeffs, ma_uint32 taps);
+
+static void ma_bridge_sinc_blend_scalar(float* pOut, const float* pCoeffs, const float* pDeltas, float frac, ma_uint32 taps) {
+    for (ma_uint32 i = 0; i < taps; ++i) pOut[i] = pCoeffs[i] + frac * pDeltas[i];
+}
+
+static float ma_bridge_sinc_dot_scalar(const float* pWindow, const float* pCoeffs, ma_uint32 taps) {
+    float acc[4] = { 0, 0, 0, 0 };
+    for (ma_uint32 i = 0; i < taps; i += 4) {
+        acc[0] += pWindow[i + 0] * pCoeffs[i + 0];
+        acc[1] += pWindow[i + 1] * pCoeffs[i + 1];
+        acc[2] += pWindow[i + 2] * pCoeffs[i + 2];
+        acc[3] += pWindow[i + 3] * pCoeffs[i + 3];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+#if defined(MA_BRIDGE_SINC_SSE2)
+static void ma_bridge_sinc_blend_sse2(float* pOut, const float* pCoeffs, const float* pDeltas, float frac, ma_uint32 taps) {
+    __m128 f = _mm_set1_ps(frac);
+    for (ma_uint32 i = 0; i < taps; i += 4) {
+        _mm_storeu_ps(pOut + i, _mm_add_ps(_mm_loadu_ps(pCoeffs + i), _mm_mul_ps(f, _mm_loadu_ps(pDeltas + i))));
+    }
+}
+
+static float ma_bridge_sinc_dot_sse2(const float* pWindow, const float* pCoeffs, ma_uint32 taps) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (ma_uint32 i = 0; i < taps; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(pWindow + i),     _mm_loadu_ps(pCoeffs + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(pWindow + i + 4), _mm_loadu_ps(pCoeffs + i + 4)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+    acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+    return _mm_cvtss_f32(acc0);
+}
+#endif
+
+#if defined(MA_BRIDGE_SINC_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+    #define MA_BRIDGE_SINC_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+    #define MA_BRIDGE_SINC_TARGET_AVX2
+#endif
+
+MA_BRIDGE_SINC_TARGET_AVX2
+static void ma_bridge_sinc_blend_avx2(float* pOut, const float* pCoeffs, const float* pDeltas, float frac, ma_uint32 taps) {
+    __m256 f = _mm256_set1_ps(frac);
+    for (ma_uint32 i = 0; i < taps; i += 8) {
+        _mm256_storeu_ps(pOut + i, _mm256_fmadd_ps(f, _mm256_loadu_ps(pDeltas + i), _mm256_loadu_ps(pCoeffs + i)));
+    }
+}
+
+MA_BRIDGE_SINC_TARGET_AVX2
+static float ma_bridge_sinc_dot_avx2(const float* pWindow, const float* pCoeffs, ma_uint32 taps) {
+    __m256 acc = _mm256_setzero_ps();
+    for (ma_uint32 i = 0; i < taps; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(pWindow + i), _mm256_loadu_ps(pCoeffs + i), acc);
+    }
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+static ma_bool32 ma_bridge_sinc_has_avx2(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info1[4], info7[4];
+    __cpuid(info1, 1);
+    __cpuidex(info7, 7, 0);
+    ma_bool32 osxsave = (info1[2] & (1 << 27)) != 0;
+    ma_bool32 fma = (info1[2] & (1 << 12)) != 0;
+    ma_bool32 avx2 = (info7[1] & (1 << 5)) != 0;
+    return osxsave && fma && avx2 && (_xgetbv(0) & 0x06) == 0x06;
+#else
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif
+
+#if defined(MA_BRIDGE_SINC_NEON)
+static void ma_bridge_sinc_blend_neon(float* pOut, const float* pCoeffs, const float* pDeltas, float frac, ma_uint32 taps) {
+    float32x4_t f = vdupq_n_f32(frac);
+    for (ma_uint32 i = 0; i < taps; i += 4) {
+        vst1q_f32(pOut + i, vmlaq_f32(vld1q_f32(pCoeffs + i), f, vld1q_f32(pDeltas + i)));
+    }
+}
+
+static float ma_bridge_sinc_dot_neon(const float* pWindow, const float* pCoeffs, ma_uint32 taps) {
+    float32x4_t acc0 = vdupq_n_f32(0);
+    float32x4_t acc1 = vdupq_n_f32(0);
+    for (ma_uint32 i = 0; i < taps; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(pWindow + i),     vld1q_f32(pCoeffs + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(pWindow + i + 4), vld1q_f32(pCoeffs + i + 4));
+    }
+    acc0 = vaddq_f32(acc0, acc1);
+    float32x2_t sum = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+}
+#endif
+
+static void ma_bridge_sinc_select_kernels(ma_bridge_sinc_blend_proc* pBlend, ma_bridge_sinc_dot_proc* pDot, const char** pName) {
+    *pBlend = ma_bridge_sinc_blend_scalar;
+    *pDot = ma_bridge_sinc_dot_scalar;
+    *pName = "scalar";
+#if defined(MA_BRIDGE_SINC_AVX2)
+    if (ma_bridge_sinc_has_avx2()) {
+        *pBlend = ma_bridge_sinc_blend_avx2;
+        *pDot = ma_bridge_sinc_dot_avx2;
+        *pName = "avx2";
+        return;
+    }
+#endif
+#if defined(MA_BRIDGE_SINC_SSE2)
+    *pBlend = ma_bridge_sinc_blend_sse2;
+    *pDot = ma_bridge_sinc_dot_sse2;
+    *pName = "sse2";
+#elif defined(MA_BRIDGE_SINC_NEON)
+    *pBlend = ma_bridge_sinc_blend_neon;
+    *pDot = ma_bridge_sinc_dot_neon;
+    *pName = "neon";
+#endif
+}
+
+const char* ma_bridge_sinc_kernel_name(void) {
+    ma_bridge_sinc_blend_proc blend;
+    ma_bridge_sinc_dot_proc dot;
+    const char* name;
+    ma_bridge_sinc_select_kernels(&blend, &dot, &name);
+    return name;
+}
+
+/* --- Filter Table --- */
+
+typedef struct {
+    const ma_bridge_sinc_quality_params* pParams;
+    ma_format format;
+    ma_uint32 channels;
+    ma_uint32 taps;
+    ma_uint32 phases;
+
+    double step;        /* Input frames advanced per output frame (in / out) */
+    double frac;        /* Read position between window[taps/2 - 1] and window[taps/2] */
+    ma_uint32 pending;  /* Input frames to load before the next output */
+    double cutoff;      /* Cutoff the table was built for, relative to input Nyquist */
+
+    float* pWindow;     /* (phases + 1) * taps, Kaiser window only (cutoff independent) */
+    float* pCoeffs;     /* (phases + 1) * taps */
+    float* pDeltas;     /* phases * taps: pCoeffs[p + 1] - pCoeffs[p] */
+    float* pHistory;    /* channels * 2 * taps, mirrored ring per channel */
+    float* pBlended;    /* taps */
+    ma_uint32 head;     /* Oldest frame in every channel's window */
+
+    ma_bridge_sinc_blend_proc blend;
+    ma_bridge_sinc_dot_proc dot;
+} ma_bridge_sinc;
+
+typedef struct {
+    size_t window, coeffs, deltas, history, blended, total;
+} ma_bridge_sinc_layout;
+
+static size_t ma_bridge_sinc_align(size_t size) {
+    return (size + (MA_BRIDGE_SINC_ALIGN - 1)) & ~(size_t)(MA_BRIDGE_SINC_ALIGN - 1);
+}
+
+static void ma_bridge_sinc_get_layout(const ma_bridge_sinc_quality_params* pParams, ma_uint32 channels, ma_bridge_sinc_layout* pLayout) {
+    size_t table = (size_t)(pParams->phases + 1) * pParams->taps * sizeof(float);
+    pLayout->window  = ma_bridge_sinc_align(sizeof(ma_bridge_sinc));
+    pLayout->coeffs  = pLayout->window + ma_bridge_sinc_align(table);
+    pLayout->deltas  = pLayout->coeffs + ma_bridge_sinc_align(table);
+    pLayout->history = pLayout->deltas + ma_bridge_sinc_align((size_t)pParams->phases * pParams->taps * sizeof(float));
+    pLayout->blended = pLayout->history + ma_bridge_sinc_align((size_t)channels * 2 * pParams->taps * sizeof(float));
+    pLayout->total   = pLayout->blended + ma_bridge_sinc_align((size_t)pParams->taps * sizeof(float));
+}
+
+/* Zeroth-order modified Bessel function of the first kind (series form) */
+static double ma_bridge_sinc_bessel_i0(double x) {
+    double sum = 1.0, term = 1.0, half = x * 0.5;
+    for (int k = 1; k < 64; ++k) {
+        term *= (half / k) * (half / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+/* Tap i at phase p sits (i - (taps/2 - 1) - p/phases) input frames from the read position. */
+static double ma_bridge_sinc_distance(const ma_bridge_sinc* pSinc, ma_uint32 phase, ma_uint32 tap) {
+    return (double)tap - (double)(pSinc->taps / 2 - 1) - (double)phase / (double)pSinc->phases;
+}
+
+static void ma_bridge_sinc_build_window(ma_bridge_sinc* pSinc) {
+    double half = (double)pSinc->taps * 0.5;
+    double norm = 1.0 / ma_bridge_sinc_bessel_i0(pSinc->pParams->beta);
+    for (ma_uint32 p = 0; p <= pSinc->phases; ++p) {
+        for (ma_uint32 i = 0; i < pSinc->taps; ++i) {
+            double x = ma_bridge_sinc_distance(pSinc, p, i) / half;
+            double w = (x <= -1.0 || x >= 1.0) ? 0.0 : ma_bridge_sinc_bessel_i0(pSinc->pParams->beta * sqrt(1.0 - x * x)) * norm;
+            pSinc->pWindow[(size_t)p * pSinc->taps + i] = (float)w;
+        }
+    }
+}
+
+/* Derive the lowpass for `cutoff` (fraction of the input Nyquist), unity gain at DC for every phase. */
+static void ma_bridge_sinc_build_table(ma_bridge_sinc* pSinc, double cutoff) {
+    const double pi = 3.14159265358979323846;
+    ma_uint32 taps = pSinc->taps;
+
+    for (ma_uint32 p = 0; p <= pSinc->phases; ++p) {
+        float* pRow = pSinc->pCoeffs + (size_t)p * taps;
+        double sum = 0;
+        for (ma_uint32 i = 0; i < taps; ++i) {
+            double x = pi * cutoff * ma_bridge_sinc_distance(pSinc, p, i);
+            double h = (fabs(x) < 1e-9 ? 1.0 : sin(x) / x) * pSinc->pWindow[(size_t)p * taps + i];
+            pRow[i] = (float)h;
+            sum += h;
+        }
+        if (sum != 0) {
+            for (ma_uint32 i = 0; i < taps; ++i) pRow[i] = (float)(pRow[i] / sum);
+        }
+    }
+    for (ma_uint32 p = 0; p < pSinc->phases; ++p) {
+        for (ma_uint32 i = 0; i < taps; ++i) {
+            size_t k = (size_t)p * taps + i;
+            pSinc->pDeltas[k] = pSinc->pCoeffs[k + taps] - pSinc->pCoeffs[k];
+        }
+    }
+    pSinc->cutoff = cutoff;
+}
+
+static double ma_bridge_sinc_cutoff_for(const ma_bridge_sinc* pSinc, ma_uint32 sampleRateIn, ma_uint32 sampleRateOut) {
+    double cutoff = pSinc->pParams->rolloff;
+    if (sampleRateOut < sampleRateIn) cutoff *= (double)sampleRateOut / (double)sampleRateIn; /* Anti-alias when downsampling */
+    return cutoff;
+}
+
+/* --- Backend --- */
+
+static const ma_bridge_sinc_quality_params* ma_bridge_sinc_params(void* pUserData) {
+    return (const ma_bridge_sinc_quality_params*)pUserData;
+}
+
+static ma_result ma_bridge_sinc_get_heap_size(void* pUserData, const ma_resampler_config* pConfig, size_t* pHeapSizeInBytes) {
+    if (pConfig->format != ma_format_f32 && pConfig->format != ma_format_s16) return MA_INVALID_ARGS;
+    ma_bridge_sinc_layout layout;
+    ma_bridge_sinc_get_layout(ma_bridge_sinc_params(pUserData), pConfig->channels, &layout);
+    *pHeapSizeInBytes = layout.total + MA_BRIDGE_SINC_ALIGN; /* Room to align the heap itself */
+    return MA_SUCCESS;
+}
+
+static ma_result ma_bridge_sinc_reset(void* pUserData, ma_resampling_backend* pBackend) {
+    (void)pUserData;
+    ma_bridge_sinc* pSinc = (ma_bridge_sinc*)pBackend;
+    memset(pSinc->pHistory, 0, (size_t)pSinc->channels * 2 * pSinc->taps * sizeof(float));
+    pSinc->head = 0;
+    pSinc->frac = 0;
+    pSinc->pending = pSinc->taps / 2; /* Read position starts on the first input frame */
+    return MA_SUCCESS;
+}
+
+static ma_result ma_bridge_sinc_init(void* pUserData, const ma_resampler_config* pConfig, void* pHeap, ma_resampling_backend** ppBackend) {
+    const ma_bridge_sinc_quality_params* pParams = ma_bridge_sinc_params(pUserData);
+    if (pConfig->format != ma_format_f32 && pConfig->format != ma_format_s16) return MA_INVALID_ARGS;
+    if (pConfig->channels == 0 || pConfig->sampleRateIn == 0 || pConfig->sampleRateOut == 0) return MA_INVALID_ARGS;
+
+    ma_uint8* pBase = (ma_uint8*)(((size_t)pHeap + (MA_BRIDGE_SINC_ALIGN - 1)) & ~(size_t)(MA_BRIDGE_SINC_ALIGN - 1));
+    ma_bridge_sinc_layout layout;
+    ma_bridge_sinc_get_layout(pParams, pConfig->channels, &layout);
+
+    ma_bridge_sinc* pSinc = (ma_bridge_sinc*)pBase;
+    memset(pSinc, 0, sizeof(*pSinc));
+    pSinc->pParams  = pParams;
+    pSinc->format   = pConfig->format;
+    pSinc->channels = pConfig->channels;
+    pSinc->taps     = pParams->taps;
+    pSinc->phases   = pParams->phases;
+    pSinc->step     = (double)pConfig->sampleRateIn / (double)pConfig->sampleRateOut;
+    pSinc->pWindow  = (float*)(pBase + layout.window);
+    pSinc->pCoeffs  = (float*)(pBase + layout.coeffs);
+    pSinc->pDeltas  = (float*)(pBase + layout.deltas);
+    pSinc->pHistory = (float*)(pBase + layout.history);
+    pSinc->pBlended = (float*)(pBase + layout.blended);
+
+    const char* name;
+    ma_bridge_sinc_select_kernels(&pSinc->blend, &pSinc->dot, &name);
+    ma_bridge_sinc_build_window(pSinc);
+    ma_bridge_sinc_build_table(pSinc, ma_bridge_sinc_cutoff_for(pSinc, pConfig->sampleRateIn, pConfig->sampleRateOut));
+    ma_bridge_sinc_reset(pUserData, (ma_resampling_backend*)pSinc);
+
+    *ppBackend = (ma_resampling_backend*)pSinc;
+    return MA_SUCCESS;
+}
+
+static void ma_bridge_sinc_uninit(void* pUserData, ma_resampling_backend* pBackend, const ma_allocation_callbacks* pAllocationCallbacks) {
+    (void)pUserData; (void)pBackend; (void)pAllocationCallbacks; /* Everything lives in the resampler's heap */
+}
+
+static MA_INLINE void ma_bridge_sinc_push(ma_bridge_sinc* pSinc, const void* pFrame) {
+    ma_uint32 taps = pSinc->taps;
+    for (ma_uint32 c = 0; c < pSinc->channels; ++c) {
+        float x;
+        if (pFrame == NULL) {
+            x = 0;
+        } else if (pSinc->format == ma_format_f32) {
+            x = ((const float*)pFrame)[c];
+        } else {
+            x = ((const ma_int16*)pFrame)[c] * (1.0f / 32768.0f);
+        }
+        float* pChannel = pSinc->pHistory + (size_t)c * 2 * taps;
+        pChannel[pSinc->head] = x;
+        pChannel[pSinc->head + taps] = x;
+    }
+    pSinc->head = (pSinc->head + 1 == taps) ? 0 : pSinc->head + 1;
+}
+
+static ma_result ma_bridge_sinc_process(void* pUserData, ma_resampling_backend* pBackend, const void* pFramesIn, ma_uint64* pFrameCountIn, void* pFramesOut, ma_uint64* pFrameCountOut) {
+    (void)pUserData;
+    ma_bridge_sinc* pSinc = (ma_bridge_sinc*)pBackend;
+    ma_uint64 inCap = *pFrameCountIn;
+    ma_uint64 outCap = *pFrameCountOut;
+    ma_uint64 inUsed = 0, outMade = 0;
+    ma_uint32 taps = pSinc->taps;
+    ma_uint32 channels = pSinc->channels;
+    size_t inStride = (size_t)channels * (pSinc->format == ma_format_f32 ? sizeof(float) : sizeof(ma_int16));
+
+    while (outMade < outCap) {
+        while (pSinc->pending > 0) {
+            if (inUsed == inCap) goto done;
+            ma_bridge_sinc_push(pSinc, pFramesIn ? (const ma_uint8*)pFramesIn + inUsed * inStride : NULL);
+            inUsed += 1;
+            pSinc->pending -= 1;
+        }
+
+        // Blend the two nearest phases for the exact read position
+        double position = pSinc->frac * pSinc->phases;
+        ma_uint32 phase = (ma_uint32)position;
+        if (phase >= pSinc->phases) phase = pSinc->phases - 1;
+        pSinc->blend(pSinc->pBlended, pSinc->pCoeffs + (size_t)phase * taps, pSinc->pDeltas + (size_t)phase * taps, (float)(position - phase), taps);
+
+        for (ma_uint32 c = 0; c < channels; ++c) {
+            float y = pSinc->dot(pSinc->pHistory + (size_t)c * 2 * taps + pSinc->head, pSinc->pBlended, taps);
+            if (pFramesOut == NULL) continue;
+            if (pSinc->format == ma_format_f32) {
+                ((float*)pFramesOut)[outMade * channels + c] = y;
+            } else {
+                float s = y * 32768.0f;
+                s = s < -32768.0f ? -32768.0f : (s > 32767.0f ? 32767.0f : s);
+                ((ma_int16*)pFramesOut)[outMade * channels + c] = (ma_int16)(s < 0 ? s - 0.5f : s + 0.5f);
+            }
+        }
+        outMade += 1;
+
+        pSinc->frac += pSinc->step;
+        ma_uint32 advance = (ma_uint32)pSinc->frac;
+        pSinc->frac -= advance;
+        pSinc->pending += advance;
+    }
+
+done:
+    *pFrameCountIn = inUsed;
+    *pFrameCountOut = outMade;
+    return MA_SUCCESS;
+}
+
+static ma_result ma_bridge_sinc_set_rate(void* pUserData, ma_resampling_backend* pBackend, ma_uint32 sampleRateIn, ma_uint32 sampleRateOut) {
+    (void)pUserData;
+    ma_bridge_sinc* pSinc = (ma_bridge_sinc*)pBackend;
+    pSinc->step = (double)sampleRateIn / (double)sampleRateOut;
+
+    // Rate control only skews by a fraction of a percent; only real rate changes re-derive the lowpass
+    double cutoff = ma_bridge_sinc_cutoff_for(pSinc, sampleRateIn, sampleRateOut);
+    if (fabs(cutoff - pSinc->cutoff) > pSinc->cutoff * MA_BRIDGE_SINC_REBUILD_TOLERANCE) {
+        ma_bridge_sinc_build_table(pSinc, cutoff);
+    }
+    return MA_SUCCESS;
+}
+
+static ma_uint64 ma_bridge_sinc_get_input_latency(void* pUserData, const ma_resampling_backend* pBackend) {
+    (void)pUserData;
+    return ((const ma_bridge_sinc*)pBackend)->taps / 2;
+}
+
+static ma_uint64 ma_bridge_sinc_get_output_latency(void* pUserData, const ma_resampling_backend* pBackend) {
+    (void)pUserData;
+    const ma_bridge_sinc* pSinc = (const ma_bridge_sinc*)pBackend;
+    return (ma_uint64)((pSinc->taps / 2) / pSinc->step + 0.5);
+}
+
+/* Mirrors the position arithmetic in process exactly, so the count is never short by one. */
+static ma_result ma_bridge_sinc_get_required_input_frame_count(void* pUserData, const ma_resampling_backend* pBackend, ma_uint64 outputFrameCount, ma_uint64* pInputFrameCount) {
+    (void)pUserData;
+    const ma_bridge_sinc* pSinc = (const ma_bridge_sinc*)pBackend;
+    ma_uint64 needed = 0;
+    if (outputFrameCount > 0) {
+        double frac = pSinc->frac;
+        needed = pSinc->pending;
+        for (ma_uint64 i = 1; i < outputFrameCount; ++i) {
+            frac += pSinc->step;
+            ma_uint32 advance = (ma_uint32)frac;
+            frac -= advance;
+            needed += advance;
+        }
+    }
+    *pInputFrameCount = needed;
+    return MA_SUCCESS;
+}
+
+static ma_result ma_bridge_sinc_get_expected_output_frame_count(void* pUserData, const ma_resampling_backend* pBackend, ma_uint64 inputFrameCount, ma_uint64* pOutputFrameCount) {
+    (void)pUserData;
+    const ma_bridge_sinc* pSinc = (const ma_bridge_sinc*)pBackend;
+    ma_uint64 produced = 0;
+    ma_uint64 consumed = pSinc->pending;
+    double frac = pSinc->frac;
+    while (consumed <= inputFrameCount) {
+        produced += 1;
+        frac += pSinc->step;
+        ma_uint32 advance = (ma_uint32)frac;
+        frac -= advance;
+        consumed += advance;
+    }
+    *pOutputFrameCount = produced;
+    return MA_SUCCESS;
+}
+
+static ma_resampling_backend_vtable g_ma_bridge_sinc_vtable = {
+    ma_bridge_sinc_get_heap_size,
+    ma_bridge_sinc_init,
+    ma_bridge_sinc_uninit,
+    ma_bridge_sinc_process,
+    ma_bridge_sinc_set_rate,
+    ma_bridge_sinc_get_input_latency,
+    ma_bridge_sinc_get_output_latency,
+    ma_bridge_sinc_get_required_input_frame_count,
+    ma_bridge_sinc_get_expected_output_frame_count,
+    ma_bridge_sinc_reset
+};
+
+void ma_bridge_sinc_config(ma_resampler_config* pConfig, ma_bridge_resample_quality quality) {
+    if (quality < ma_bridge_resample_quality_low || quality > ma_bridge_resample_quality_high) {
+        pConfig->algorithm = ma_resample_algorithm_linear;
+        return;
+    }
+    pConfig->algorithm = ma_resample_algorithm_custom;
+    pConfig->pBackendVTable = &g_ma_bridge_sinc_vtable;
+    pConfig->pBackendUserData = (void*)&g_sinc_quality[quality - ma_bridge_resample_quality_low];
+}
@@ -0,0 +1,39 @@
+/*
+ * miniaudio_bridge_sinc.h - Polyphase sinc resampler for the bridge
+ *
+ * Band-limited polyphase resampler (Kaiser-windowed sinc) plugged into
+ * ma_resampler as a custom backend. Works on s16 or f32 interleaved frames,
+ * accepts any ratio and follows continuous ratio changes (rate control)
+ * without clicks. Inner loops use SSE2, AVX2/FMA or NEON when available.
+ */
+
+#ifndef MINIAUDIO_BRIDGE_SINC_H
+#define MINIAUDIO_BRIDGE_SINC_H
+
+#include "miniaudio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ma_bridge_resample_quality_linear = 0,  /* miniaudio's linear resampler */
+    ma_bridge_resample_quality_low    = 1,  /*  8 taps,  64 phases */
+    ma_bridge_resample_quality_medium = 2,  /* 16 taps, 128 phases */
+    ma_bridge_resample_quality_high   = 3   /* 32 taps, 256 phases */
+} ma_bridge_resample_quality;
+
+/**
+ * Point a resampler config at the sinc backend for the given quality.
+ * Linear (or an unknown quality) leaves the config on ma_resample_algorithm_linear.
+ */
+void ma_bridge_sinc_config(ma_resampler_config* pConfig, ma_bridge_resample_quality quality);
+
+/** Name of the SIMD kernel the sinc backend uses on this CPU ("avx2", "sse2", "neon" or "scalar"). */
+const char* ma_bridge_sinc_kernel_name(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MINIAUDIO_BRIDGE_SINC_H */